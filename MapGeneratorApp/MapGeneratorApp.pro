@@ -39,8 +39,11 @@ SOURCES += \
         ../ScenarioGenerator/src/blueprint.cpp \
         ../ScenarioGenerator/src/currency.cpp \
         ../ScenarioGenerator/src/decoration.cpp \
+        ../ScenarioGenerator/src/distancetransform.cpp \
+        ../ScenarioGenerator/src/freepathfield.cpp \
         ../ScenarioGenerator/src/gameinfo.cpp \
         ../ScenarioGenerator/src/generatorsettings.cpp \
+        ../ScenarioGenerator/src/gridpathfinder.cpp \
         ../ScenarioGenerator/src/image.cpp \
         ../ScenarioGenerator/src/itempicker.cpp \
         ../ScenarioGenerator/src/landmarkpicker.cpp \
@@ -89,6 +92,7 @@ SOURCES += \
         ../ScenarioGenerator/src/templatezone.cpp \
         ../ScenarioGenerator/src/textconvert.cpp \
         ../ScenarioGenerator/src/texts.cpp \
+        ../ScenarioGenerator/src/threadpool.cpp \
         ../ScenarioGenerator/src/unitpicker.cpp \
         ../ScenarioGenerator/src/zoneplacer.cpp \
         ../dbf.cpp \
@@ -135,10 +139,13 @@ HEADERS += \
         ../ScenarioGenerator/src/containers.h \
         ../ScenarioGenerator/src/currency.h \
         ../ScenarioGenerator/src/decoration.h \
+        ../ScenarioGenerator/src/distancetransform.h \
         ../ScenarioGenerator/src/enums.h \
         ../ScenarioGenerator/src/exceptions.h \
+        ../ScenarioGenerator/src/freepathfield.h \
         ../ScenarioGenerator/src/gameinfo.h \
         ../ScenarioGenerator/src/generatorsettings.h \
+        ../ScenarioGenerator/src/gridpathfinder.h \
         ../ScenarioGenerator/src/image.h \
         ../ScenarioGenerator/src/iteminfo.h \
         ../ScenarioGenerator/src/itempicker.h \
@@ -152,6 +159,7 @@ HEADERS += \
         ../ScenarioGenerator/src/picker.h \
         ../ScenarioGenerator/src/position.h \
         ../ScenarioGenerator/src/raceinfo.h \
+        ../ScenarioGenerator/src/randomengines.h \
         ../ScenarioGenerator/src/randomgenerator.h \
         ../ScenarioGenerator/src/scenario/bag.h \
         ../ScenarioGenerator/src/scenario/capital.h \
@@ -199,6 +207,8 @@ HEADERS += \
         ../ScenarioGenerator/src/templatezone.h \
         ../ScenarioGenerator/src/textconvert.h \
         ../ScenarioGenerator/src/texts.h \
+        ../ScenarioGenerator/src/threadpool.h \
+        ../ScenarioGenerator/src/tilegrid.h \
         ../ScenarioGenerator/src/tileinfo.h \
         ../ScenarioGenerator/src/unitinfo.h \
         ../ScenarioGenerator/src/unitpicker.h \
@@ -530,7 +530,7 @@ void MapGeneratorApp::updatePreviewImages()
 
             const std::size_t index = i + width * j;
 
-            const auto zoneId{generator->zoneColoring[generator->posToIndex(pos)]};
+            const auto zoneId{generator->getZoneId(pos)};
 
             if (zoneId < std::size(colors)) {
                 pixels[index] = colors[zoneId];
@@ -540,7 +540,7 @@ void MapGeneratorApp::updatePreviewImages()
                 pixels[index] = RgbColor(c, c, c);
             }
 
-            auto& tile{generator->tiles[generator->posToIndex(pos)]};
+            const auto tile{generator->getTile(pos)};
 
             if (tile.isRoad()) {
                 pixels2[index] = RgbColor(175, 175, 175); // grey
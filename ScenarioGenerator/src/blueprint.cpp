@@ -36,10 +36,9 @@ Blueprint::Blueprint(MapGenerator& mapGenerator, const Position& position, const
     , placed{true}
 {
     // Mark tiles occupied by blueprint as used
-    auto occupiedTiles{mapElement.getBlockedPositions()};
-    occupiedTiles.insert(mapElement.getEntrance());
+    for (const auto& offset : mapElement.getBlockedOffsets()) {
+        const Position tile{position + offset};
 
-    for (const Position& tile : occupiedTiles) {
         if (!mapGenerator.map->isInTheMap(tile) || !mapGenerator.isPossible(tile)) {
             std::stringstream stream;
             stream << "Could not place blueprint at " << position << ". Tile " << tile
@@ -58,11 +57,9 @@ Blueprint::~Blueprint()
         return;
     }
 
-    auto occupiedTiles{mapElement.getBlockedPositions()};
-    occupiedTiles.insert(mapElement.getEntrance());
-
-    for (const Position& tile : occupiedTiles) {
-        mapGenerator.setOccupied(tile, TileType::Possible);
+    const auto& position{mapElement.getPosition()};
+    for (const auto& offset : mapElement.getBlockedOffsets()) {
+        mapGenerator.setOccupied(position + offset, TileType::Possible);
     }
 }
 
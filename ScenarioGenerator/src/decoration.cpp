@@ -99,10 +99,9 @@ std::set<Position> Decoration::getMapElementArea(const MapElement& mapElement,
     return decorationsArea;
 }
 
-const LandmarkFilterList& Decoration::getLandmarkFilters()
+LandmarkConstraints Decoration::getLandmarkConstraints() const
 {
-    static const LandmarkFilterList filters{};
-    return filters;
+    return {};
 }
 
 std::set<Position> Decoration::getArea(TemplateZone&, MapGenerator&, Map&, RandomGenerator&)
@@ -137,12 +136,13 @@ bool Decoration::placeLandmarks(std::set<Position>& area,
                                 RandomGenerator& rand)
 {
     const std::size_t landmarksTotal{rand.pickValue(landmarks)};
-    const auto& landmarkFilters{getLandmarkFilters()};
+    const auto constraints{getLandmarkConstraints()};
+    const auto& landmarkIndex{mapGenerator.getPickPools().landmarks};
 
     for (std::size_t i = 0; i < landmarksTotal; ++i) {
         const auto landmarkRace{getLandmarksRace(zone, mapGenerator, map, rand)};
 
-        const auto* info{pickLandmark(landmarkRace, rand, landmarkFilters)};
+        const auto* info{landmarkIndex.pick(landmarkRace, constraints, rand)};
         if (!info) {
             break;
         }
@@ -156,7 +156,7 @@ bool Decoration::placeLandmarks(std::set<Position>& area,
         }
 
         // Create landmark object
-        const auto landmarkId{mapGenerator.createId(CMidgardID::Type::Landmark)};
+        const auto landmarkId{zone.createId(CMidgardID::Type::Landmark)};
         auto landmark{std::make_unique<Landmark>(landmarkId, info->getSize())};
         landmark->setTypeId(info->getLandmarkId());
 
@@ -205,22 +205,15 @@ bool Decoration::placeForests(std::set<Position>& area,
     return true;
 }
 
-const LandmarkFilterList& CapitalDecoration::getLandmarkFilters()
+LandmarkConstraints CapitalDecoration::getLandmarkConstraints() const
 {
-    // clang-format off
-    static const LandmarkFilterList filters{
-        // Pick landmarks that are smaller than capital
-        [size = capital->getSize().x]( const LandmarkInfo* info) {
-            return info->getSize().x >= size;
-        },
-        // Pick landmarks that allow terrain spread
-        [](const LandmarkInfo* info) {
-            return info->isMountain() == true;
-        }
-    };
-    // clang-format on
+    LandmarkConstraints constraints;
+    // Pick landmarks that are smaller than capital
+    constraints.maxSize = capital->getSize().x - 1;
+    // Pick landmarks that allow terrain spread
+    constraints.allowMountains = false;
 
-    return filters;
+    return constraints;
 }
 
 std::set<Position> CapitalDecoration::getArea(TemplateZone& zone,
@@ -258,27 +251,18 @@ TerrainType CapitalDecoration::getForestsTerrain(TemplateZone& zone,
     return getLandmarksTerrain(zone, mapGenerator, map, rand);
 }
 
-const LandmarkFilterList& VillageDecoration::getLandmarkFilters()
-{
-    // clang-format off
-    static const LandmarkFilterList filters{
-        // Pick landmarks that are smaller than village
-        [size = village->getSize().x] (const LandmarkInfo* info) {
-            return info->getSize().x > size;
-        },
-        // Pick landmarks that allow terrain spread, necessary for the villages
-        [](const LandmarkInfo* info) {
-            return info->isMountain() == true;
-        },
-        // Don't pick cemeteries and skeletons for high tier cities
-        // I think they look ugly, especially in high quantities
-        [tier = village->getTier()](const LandmarkInfo* info) {
-            return info->getLandmarkType() == LandmarkType::Misc && tier >= 3;
-        }
-    };
-    // clang-format on
+LandmarkConstraints VillageDecoration::getLandmarkConstraints() const
+{
+    LandmarkConstraints constraints;
+    // Pick landmarks that are not bigger than village
+    constraints.maxSize = village->getSize().x;
+    // Pick landmarks that allow terrain spread, necessary for the villages
+    constraints.allowMountains = false;
+    // Don't pick cemeteries and skeletons for high tier cities
+    // I think they look ugly, especially in high quantities
+    constraints.allowMisc = village->getTier() < 3;
 
-    return filters;
+    return constraints;
 }
 
 std::set<Position> VillageDecoration::getArea(TemplateZone& zone,
@@ -286,7 +270,7 @@ std::set<Position> VillageDecoration::getArea(TemplateZone& zone,
                                               Map& map,
                                               RandomGenerator& rand)
 {
-    return getMapElementArea(*village, 4, 4, zone, mapGenerator, map, rand);
+    return getMapElementArea(*village, maxGapSize, maxGapSize, zone, mapGenerator, map, rand);
 }
 
 int VillageDecoration::getMinLandmarkDistance(const LandmarkInfo& info) const
@@ -340,22 +324,15 @@ bool CrystalDecoration::decorate(TemplateZone& zone,
     return placeLandmarks(decorationsArea, zone, mapGenerator, map, rand);
 }
 
-const LandmarkFilterList& CrystalDecoration::getLandmarkFilters()
+LandmarkConstraints CrystalDecoration::getLandmarkConstraints() const
 {
-    // clang-format off
-    static const LandmarkFilterList filters{
-        // Pick landmarks that are smaller than crystal
-        [size = crystal->getSize().x] (const LandmarkInfo* info) {
-            return info->getSize().x > size;
-        },
-        // Pick landmarks that allow terrain spread
-        [](const LandmarkInfo* info) {
-            return info->isMountain() == true;
-        }
-    };
-    // clang-format on
+    LandmarkConstraints constraints;
+    // Pick landmarks that are not bigger than crystal
+    constraints.maxSize = crystal->getSize().x;
+    // Pick landmarks that allow terrain spread
+    constraints.allowMountains = false;
 
-    return filters;
+    return constraints;
 }
 
 std::set<Position> CrystalDecoration::getArea(TemplateZone& zone,
@@ -465,18 +442,13 @@ bool CapturedCrystalDecoration::decorate(TemplateZone& zone,
     return true;
 }
 
-const LandmarkFilterList& SiteDecoration::getLandmarkFilters()
+LandmarkConstraints SiteDecoration::getLandmarkConstraints() const
 {
-    // clang-format off
-    static const LandmarkFilterList filters{
-        // Pick landmarks that are smaller than site
-        [size = site->getSize().x] (const LandmarkInfo* info) {
-            return info->getSize().x > size;
-        }
-    };
-    // clang-format on
+    LandmarkConstraints constraints;
+    // Pick landmarks that are not bigger than site
+    constraints.maxSize = site->getSize().x;
 
-    return filters;
+    return constraints;
 }
 
 std::set<Position> SiteDecoration::getArea(TemplateZone& zone,
@@ -515,7 +487,7 @@ std::set<Position> RuinDecoration::getArea(TemplateZone& zone,
                                            Map& map,
                                            RandomGenerator& rand)
 {
-    return getMapElementArea(*ruin, 4, 4, zone, mapGenerator, map, rand);
+    return getMapElementArea(*ruin, maxGapSize, maxGapSize, zone, mapGenerator, map, rand);
 }
 
 int RuinDecoration::getMinLandmarkDistance(const LandmarkInfo& info) const
@@ -44,6 +44,9 @@ class Decoration
 public:
     using RndValue = RandomValue<std::uint32_t>;
 
+    // Decorations are placed not further than this number of tiles from map element bounds
+    static constexpr int maxGapSize{4};
+
     virtual ~Decoration() = default;
 
     // Places landmarks in specified area around map element,
@@ -68,8 +71,8 @@ protected:
                                          Map& map,
                                          RandomGenerator& rand);
 
-    // Returns list of filters for landmark picker
-    virtual const LandmarkFilterList& getLandmarkFilters();
+    // Returns properties of landmarks allowed for pick
+    virtual LandmarkConstraints getLandmarkConstraints() const;
     // Returns tiles to decorate
     virtual std::set<Position> getArea(TemplateZone& zone,
                                        MapGenerator& mapGenerator,
@@ -128,7 +131,7 @@ public:
     ~CapitalDecoration() override = default;
 
 protected:
-    const LandmarkFilterList& getLandmarkFilters() override;
+    LandmarkConstraints getLandmarkConstraints() const override;
 
     std::set<Position> getArea(TemplateZone& zone,
                                MapGenerator& mapGenerator,
@@ -165,7 +168,7 @@ public:
     ~VillageDecoration() override = default;
 
 protected:
-    const LandmarkFilterList& getLandmarkFilters() override;
+    LandmarkConstraints getLandmarkConstraints() const override;
 
     std::set<Position> getArea(TemplateZone& zone,
                                MapGenerator& mapGenerator,
@@ -209,7 +212,7 @@ public:
                   RandomGenerator& rand) override;
 
 protected:
-    const LandmarkFilterList& getLandmarkFilters() override;
+    LandmarkConstraints getLandmarkConstraints() const override;
 
     std::set<Position> getArea(TemplateZone& zone,
                                MapGenerator& mapGenerator,
@@ -270,7 +273,7 @@ public:
     ~SiteDecoration() override = default;
 
 protected:
-    const LandmarkFilterList& getLandmarkFilters() override;
+    LandmarkConstraints getLandmarkConstraints() const override;
 
     std::set<Position> getArea(TemplateZone& zone,
                                MapGenerator& mapGenerator,
@@ -0,0 +1,106 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "distancetransform.h"
+#include <algorithm>
+#include <cassert>
+#include <limits>
+
+namespace rsg {
+
+// Computes distances along one row or column.
+// Output is the lower envelope of parabolas rooted at each element
+static void transformLine(const std::vector<int>& values,
+                          std::vector<int>& distances,
+                          std::vector<int>& vertices,
+                          std::vector<double>& boundaries,
+                          int length)
+{
+    auto intersection = [&values](int q, int p) {
+        const double qq{static_cast<double>(values[q]) + static_cast<double>(q) * q};
+        const double pp{static_cast<double>(values[p]) + static_cast<double>(p) * p};
+
+        return (qq - pp) / (2.0 * (q - p));
+    };
+
+    int k{};
+    vertices[0] = 0;
+    boundaries[0] = -std::numeric_limits<double>::infinity();
+    boundaries[1] = std::numeric_limits<double>::infinity();
+
+    for (int q = 1; q < length; ++q) {
+        double s{intersection(q, vertices[k])};
+        while (s <= boundaries[k]) {
+            --k;
+            s = intersection(q, vertices[k]);
+        }
+
+        ++k;
+        vertices[k] = q;
+        boundaries[k] = s;
+        boundaries[k + 1] = std::numeric_limits<double>::infinity();
+    }
+
+    k = 0;
+    for (int q = 0; q < length; ++q) {
+        while (boundaries[k + 1] < q) {
+            ++k;
+        }
+
+        const int offset{q - vertices[k]};
+        distances[q] = std::min(offset * offset + values[vertices[k]],
+                                2 * distanceTransformInfinity);
+    }
+}
+
+void squaredDistanceTransform(std::vector<int>& grid, int width, int height)
+{
+    assert(grid.size() == static_cast<std::size_t>(width) * height);
+
+    const auto length{static_cast<std::size_t>(std::max(width, height))};
+    std::vector<int> values(length);
+    std::vector<int> distances(length);
+    std::vector<int> vertices(length);
+    std::vector<double> boundaries(length + 1);
+
+    // Columns first
+    for (int x = 0; x < width; ++x) {
+        for (int y = 0; y < height; ++y) {
+            values[y] = grid[x + y * width];
+        }
+
+        transformLine(values, distances, vertices, boundaries, height);
+
+        for (int y = 0; y < height; ++y) {
+            grid[x + y * width] = distances[y];
+        }
+    }
+
+    // Then rows, using column distances
+    for (int y = 0; y < height; ++y) {
+        const auto row{grid.begin() + y * width};
+        std::copy(row, row + width, values.begin());
+
+        transformLine(values, distances, vertices, boundaries, width);
+
+        std::copy(distances.begin(), distances.begin() + width, row);
+    }
+}
+
+} // namespace rsg
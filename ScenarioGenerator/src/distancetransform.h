@@ -0,0 +1,37 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+
+namespace rsg {
+
+// Value of tiles that are infinitely far from any source tile.
+// Small enough to keep sums with squared distances on the map within int
+static constexpr int distanceTransformInfinity{1 << 24};
+
+// Computes exact squared euclidean distances to the closest source tile in linear time,
+// using separable algorithm by Felzenszwalb and Huttenlocher.
+// Grid is stored row by row, source tiles must be set to 0
+// and all other tiles to distanceTransformInfinity.
+// Tiles that can not reach any source keep values not less than distanceTransformInfinity
+void squaredDistanceTransform(std::vector<int>& grid, int width, int height);
+
+} // namespace rsg
@@ -0,0 +1,220 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "freepathfield.h"
+#include "tilegrid.h"
+#include <algorithm>
+#include <functional>
+
+namespace rsg {
+
+void FreePathField::reset(TemplateZoneId zone)
+{
+    zoneId = zone;
+    built = false;
+    grid.setTrackChanges(zoneId, false);
+}
+
+void FreePathField::update()
+{
+    const auto& changes{grid.getChangedTiles(zoneId)};
+
+    // Rebuilding is cheaper than processing large number of changes
+    if (!built || changes.size() > grid.getTotalTiles() / 8) {
+        build();
+        return;
+    }
+
+    if (changes.empty()) {
+        return;
+    }
+
+    invalidated.clear();
+    seeds.clear();
+
+    for (const auto index : changes) {
+        const auto oldType{tileTypes[index]};
+        const auto newType{grid.getTileType(index)};
+        if (oldType == newType) {
+            // Tile was changed several times and returned to its previous state
+            continue;
+        }
+
+        tileTypes[index] = newType;
+
+        if ((isSource(oldType) && !isSource(newType))
+            || (isPassable(oldType) && !isPassable(newType))) {
+            // Distances of tile itself and tiles which paths went through it can grow
+            if (distances[index] != unreachable) {
+                push(distances[index], index);
+            }
+        }
+
+        if (isPassable(newType)) {
+            seeds.push_back(index);
+        }
+    }
+
+    grid.clearChangedTiles(zoneId);
+
+    invalidate();
+    recompute();
+}
+
+void FreePathField::build()
+{
+    const auto total{grid.getTotalTiles()};
+
+    distances.assign(total, unreachable);
+    tileTypes.resize(total);
+    queue.clear();
+
+    for (std::size_t index = 0; index < total; ++index) {
+        // Tiles of other zones can be changed by other threads, treat them as blocked
+        if (grid.getZoneId(index) != zoneId) {
+            tileTypes[index] = TileType::Blocked;
+            continue;
+        }
+
+        tileTypes[index] = grid.getTileType(index);
+
+        if (isSource(tileTypes[index])) {
+            distances[index] = 0;
+            queue.emplace_back(0, index);
+        }
+    }
+
+    propagate();
+
+    grid.setTrackChanges(zoneId, true);
+    built = true;
+}
+
+void FreePathField::invalidate()
+{
+    // Tiles are checked in order of increasing distance,
+    // so tile is checked only after all tiles its shortest paths go through
+    while (!queue.empty()) {
+        const auto [distance, index] = pop();
+        if (distance != distances[index] || hasShortestPath(index)) {
+            continue;
+        }
+
+        distances[index] = unreachable;
+        invalidated.push_back(index);
+
+        grid.foreachDirectNeighbor(index, [this, distance = distance](std::size_t neighbor) {
+            if (grid.getZoneId(neighbor) == zoneId && distances[neighbor] == distance + 1) {
+                push(distance + 1, neighbor);
+            }
+        });
+    }
+}
+
+void FreePathField::recompute()
+{
+    auto updateTile = [this](std::size_t index) {
+        const auto type{tileTypes[index]};
+        if (!isPassable(type)) {
+            return;
+        }
+
+        int distance{unreachable};
+        if (isSource(type)) {
+            distance = 0;
+        } else {
+            grid.foreachDirectNeighbor(index, [this, &distance](std::size_t neighbor) {
+                if (grid.getZoneId(neighbor) == zoneId && distances[neighbor] != unreachable) {
+                    distance = std::min(distance, distances[neighbor] + 1);
+                }
+            });
+        }
+
+        if (distance < distances[index]) {
+            distances[index] = distance;
+            push(distance, index);
+        }
+    };
+
+    for (const auto index : invalidated) {
+        updateTile(index);
+    }
+
+    for (const auto index : seeds) {
+        updateTile(index);
+    }
+
+    propagate();
+}
+
+void FreePathField::propagate()
+{
+    std::make_heap(queue.begin(), queue.end(), std::greater<Entry>());
+
+    while (!queue.empty()) {
+        const auto [distance, index] = pop();
+        if (distance != distances[index]) {
+            // Tile was reached again with better distance
+            continue;
+        }
+
+        grid.foreachDirectNeighbor(index, [this, distance = distance](std::size_t neighbor) {
+            if (grid.getZoneId(neighbor) == zoneId && isPassable(tileTypes[neighbor])
+                && distance + 1 < distances[neighbor]) {
+                distances[neighbor] = distance + 1;
+                push(distance + 1, neighbor);
+            }
+        });
+    }
+}
+
+void FreePathField::push(int distance, std::size_t index)
+{
+    queue.emplace_back(distance, index);
+    std::push_heap(queue.begin(), queue.end(), std::greater<Entry>());
+}
+
+FreePathField::Entry FreePathField::pop()
+{
+    std::pop_heap(queue.begin(), queue.end(), std::greater<Entry>());
+
+    const Entry entry{queue.back()};
+    queue.pop_back();
+    return entry;
+}
+
+bool FreePathField::hasShortestPath(std::size_t index) const
+{
+    const auto type{tileTypes[index]};
+    if (!isPassable(type)) {
+        return false;
+    }
+
+    const auto distance{distances[index]};
+    if (isSource(type)) {
+        return distance == 0;
+    }
+
+    // Tile keeps its distance while there is a neighbor one step closer to free tiles
+    return grid.foreachDirectNeighbor(index, [this, distance](std::size_t neighbor) {
+        return grid.getZoneId(neighbor) == zoneId && distances[neighbor] == distance - 1;
+    });
+}
+
+} // namespace rsg
@@ -0,0 +1,96 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "enums.h"
+#include "zoneid.h"
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace rsg {
+
+class TileGrid;
+
+// Distances of straight paths from zone tiles to the closest free tile of the zone.
+// Free and possible tiles are passable, paths never leave the zone.
+// Field is built on first update and then kept up to date using tile changes
+// recorded by TileGrid, only tiles which distances were affected are recomputed.
+class FreePathField
+{
+public:
+    static constexpr int unreachable{std::numeric_limits<int>::max()};
+
+    FreePathField(TileGrid& grid)
+        : grid{grid}
+    { }
+
+    // Forgets field, next update builds field of specified zone from scratch.
+    // Stops recording tile changes of the zone
+    void reset(TemplateZoneId zone);
+
+    // Applies tile changes made since previous update
+    void update();
+
+    // Returns number of straight steps from zone tile to the closest free tile of the zone.
+    // Returns unreachable if tile is not passable, belongs to other zone
+    // or free tiles can not be reached from it
+    int getDistance(std::size_t index) const
+    {
+        return distances[index];
+    }
+
+private:
+    using Entry = std::pair<int /* distance */, std::size_t /* index */>;
+
+    void build();
+    // Invalidates distances of tiles that lost their shortest paths
+    void invalidate();
+    // Sets distances of invalidated and seed tiles, propagates decreased distances
+    void recompute();
+    void propagate();
+    void push(int distance, std::size_t index);
+    Entry pop();
+    bool hasShortestPath(std::size_t index) const;
+
+    static bool isSource(TileType type)
+    {
+        return type == TileType::Free;
+    }
+
+    static bool isPassable(TileType type)
+    {
+        return type == TileType::Free || type == TileType::Possible;
+    }
+
+    TileGrid& grid;
+    std::vector<int> distances;
+    // Tile types at the time of previous update
+    std::vector<TileType> tileTypes;
+    // Min-heap of tiles ordered by distance
+    std::vector<Entry> queue;
+    std::vector<std::size_t> invalidated;
+    std::vector<std::size_t> seeds;
+    TemplateZoneId zoneId{-1};
+    bool built{};
+};
+
+} // namespace rsg
@@ -129,7 +129,18 @@ static std::size_t findCi(const std::string& string, const std::string_view& sub
     return it - string.begin();
 }
 
-static void readObjectImages(std::set<int>& images, const StringSet& names, const char* namePrefix)
+// Inserts image keeping images sorted and unique
+static void addObjectImage(std::vector<int>& images, int image)
+{
+    auto it{std::lower_bound(images.begin(), images.end(), image)};
+    if (it == images.end() || *it != image) {
+        images.insert(it, image);
+    }
+}
+
+static void readObjectImages(std::vector<int>& images,
+                             const StringSet& names,
+                             const char* namePrefix)
 {
     const std::size_t prefixLength = std::strlen(namePrefix);
 
@@ -149,7 +160,7 @@ static void readObjectImages(std::set<int>& images, const StringSet& names, cons
             throw std::runtime_error("Could not read object image " + name);
         }
 
-        images.insert(image);
+        addObjectImage(images, image);
     }
 }
 
@@ -291,9 +302,9 @@ static void processBagRecord(const std::string& recordName)
     }
 
     if (onLand) {
-        generatorSettings.bags.images.insert(image);
+        addObjectImage(generatorSettings.bags.images, image);
     } else {
-        generatorSettings.bags.waterImages.insert(image);
+        addObjectImage(generatorSettings.bags.waterImages, image);
     }
 }
 
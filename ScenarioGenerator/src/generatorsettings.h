@@ -65,12 +65,13 @@ struct GeneratorSettings
     // Mountain sizes and their corresponding images from IsoTerrn.ff
     std::vector<Mountain> mountains;
 
+    // Images are kept sorted and unique in vectors, so random image is picked in constant time
     struct ObjectImages
     {
         // Images on terrain
-        std::set<int> images;
+        std::vector<int> images;
         // Images in/on water
-        std::set<int> waterImages;
+        std::vector<int> waterImages;
     };
 
     ObjectImages bags;
@@ -0,0 +1,58 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "gridpathfinder.h"
+
+namespace rsg {
+
+void GridPathfinder::resize(std::size_t totalTiles)
+{
+    cameFrom.assign(totalTiles, noTile);
+    distances.assign(totalTiles, 0.f);
+    reachedStamps.assign(totalTiles, 0);
+    closedStamps.assign(totalTiles, 0);
+    generation = 0;
+    totalSearches = 0;
+    totalExpandedTiles = 0;
+}
+
+void GridPathfinder::begin(std::size_t start)
+{
+    open.clear();
+    closedTiles.clear();
+    heapSize = 0;
+
+    ++generation;
+    if (generation == 0) {
+        // Counter wrapped around, stamps of old searches can match again
+        std::fill(reachedStamps.begin(), reachedStamps.end(), 0);
+        std::fill(closedStamps.begin(), closedStamps.end(), 0);
+        generation = 1;
+    }
+
+    relax(noTile, start, 0.f);
+}
+
+void GridPathfinder::finish()
+{
+    ++totalSearches;
+    totalExpandedTiles += closedTiles.size();
+}
+
+} // namespace rsg
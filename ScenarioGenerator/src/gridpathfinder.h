@@ -0,0 +1,229 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace rsg {
+
+// Best-first search over tile indices of TileGrid.
+// Per-tile state is kept in flat arrays that are reused between searches.
+// Instead of clearing them, each search increments generation counter
+// and tile state is considered valid only if its stamp matches current generation.
+class GridPathfinder
+{
+public:
+    static constexpr std::size_t noTile{std::numeric_limits<std::size_t>::max()};
+
+    // Heuristic that turns search into Dijkstra algorithm
+    struct NoHeuristic
+    {
+        float operator()(std::size_t) const
+        {
+            return 0.f;
+        }
+    };
+
+    // Prepares per-tile arrays for grid with specified total number of tiles
+    void resize(std::size_t totalTiles);
+
+    // Searches path starting from tile with specified index.
+    // isGoal(std::size_t index) returns true if search should stop at tile.
+    // expand(std::size_t index, float distance) calls relax() for each neighbor tile
+    // that can be entered from tile, distance is the cost of path from start to tile.
+    // heuristic(std::size_t index) returns estimated cost of path from tile to the goal.
+    // It must never overestimate and must be consistent, otherwise found path
+    // will not be the cheapest one.
+    // Tiles are expanded in order of increasing distance plus heuristic, ties are resolved
+    // the same way as std::priority_queue does.
+    // Tile that was reached several times is expanded once per reach, later expansions
+    // get distance that is worse than getDistance(). Policies that do not need them
+    // can skip such expansions.
+    // Returns index of reached goal tile or noTile if goal is unreachable
+    template <typename GoalPolicy, typename ExpandPolicy, typename Heuristic = NoHeuristic>
+    std::size_t search(std::size_t start,
+                       GoalPolicy&& isGoal,
+                       ExpandPolicy&& expand,
+                       Heuristic&& heuristic = Heuristic{})
+    {
+        begin(start);
+        schedule(heuristic);
+
+        std::size_t goal{noTile};
+        while (!open.empty()) {
+            const Node node{popNext()};
+            if (isGoal(node.index)) {
+                goal = node.index;
+                break;
+            }
+
+            expand(node.index, node.distance);
+            schedule(heuristic);
+        }
+
+        finish();
+        return goal;
+    }
+
+    // Returns true if tile is not expanded yet and distance is better than known one
+    bool canImprove(std::size_t index, float distance) const
+    {
+        if (isClosed(index)) {
+            return false;
+        }
+
+        return !isReached(index) || distance < distances[index];
+    }
+
+    // Reaches tile from neighbor tile with specified path cost.
+    // Must be called only from expand policy.
+    // Returns true if tile was updated and scheduled for expansion
+    bool relax(std::size_t from, std::size_t to, float distance)
+    {
+        if (!canImprove(to, distance)) {
+            return false;
+        }
+
+        reachedStamps[to] = generation;
+        cameFrom[to] = from;
+        distances[to] = distance;
+
+        // Priority is assigned when policy finishes tile expansion
+        open.push_back(Node{to, distance, distance});
+        return true;
+    }
+
+    // Returns true if tile was reached during last search
+    bool isReached(std::size_t index) const
+    {
+        return reachedStamps[index] == generation;
+    }
+
+    // Returns true if tile was expanded during last search
+    bool isClosed(std::size_t index) const
+    {
+        return closedStamps[index] == generation;
+    }
+
+    // Returns cost of the best path from start to tile found during last search
+    float getDistance(std::size_t index) const
+    {
+        return distances[index];
+    }
+
+    // Returns tiles expanded during last search, in order of expansion
+    const std::vector<std::size_t>& getClosedTiles() const
+    {
+        return closedTiles;
+    }
+
+    // Returns number of distinct tiles expanded during last search
+    std::size_t getExpandedTiles() const
+    {
+        return closedTiles.size();
+    }
+
+    // Returns number of searches done since last resize
+    std::size_t getTotalSearches() const
+    {
+        return totalSearches;
+    }
+
+    // Returns number of tiles expanded by all searches since last resize
+    std::size_t getTotalExpandedTiles() const
+    {
+        return totalExpandedTiles;
+    }
+
+    // Calls f for each tile of the path from tile back to search start, excluding start itself
+    template <typename F>
+    void tracePath(std::size_t index, F&& f) const
+    {
+        for (; cameFrom[index] != noTile; index = cameFrom[index]) {
+            f(index);
+        }
+    }
+
+private:
+    struct Node
+    {
+        std::size_t index;
+        float distance;
+        float priority;
+    };
+
+    // Same ordering as A* priority queue in TemplateZone
+    struct NodeComparer
+    {
+        bool operator()(const Node& a, const Node& b) const
+        {
+            return b.priority < a.priority;
+        }
+    };
+
+    void begin(std::size_t start);
+    void finish();
+
+    // Removes tile with the best priority from open list and marks it as expanded
+    Node popNext()
+    {
+        std::pop_heap(open.begin(), open.end(), NodeComparer{});
+        const Node node{open.back()};
+        open.pop_back();
+        heapSize = open.size();
+
+        if (!isClosed(node.index)) {
+            closedStamps[node.index] = generation;
+            closedTiles.push_back(node.index);
+        }
+
+        return node;
+    }
+
+    // Assigns priorities to tiles reached by the last expansion and adds them to the heap
+    // in the order they were reached
+    template <typename Heuristic>
+    void schedule(Heuristic& heuristic)
+    {
+        for (std::size_t i = heapSize; i < open.size(); ++i) {
+            open[i].priority = open[i].distance + heuristic(open[i].index);
+            std::push_heap(open.begin(), open.begin() + i + 1, NodeComparer{});
+        }
+
+        heapSize = open.size();
+    }
+
+    std::vector<Node> open;
+    std::vector<std::size_t> closedTiles;
+    std::vector<std::size_t> cameFrom;
+    std::vector<float> distances;
+    std::vector<std::uint32_t> reachedStamps;
+    std::vector<std::uint32_t> closedStamps;
+    std::size_t heapSize{};
+    std::size_t totalSearches{};
+    std::size_t totalExpandedTiles{};
+    std::uint32_t generation{};
+};
+
+} // namespace rsg
@@ -21,25 +21,86 @@
 #include "containers.h"
 #include "gameinfo.h"
 #include "generatorsettings.h"
-#include "picker.h"
+#include "randomgenerator.h"
+#include <algorithm>
+#include <cassert>
 
 namespace rsg {
 
-ItemInfo* pickItem(const std::vector<ItemInfo*>& itemPool,
-                   RandomGenerator& random,
-                   const ItemFilterList& filters)
+ItemIndex::ItemIndex(const std::vector<ItemInfo*>& itemPool)
 {
-    return pick(itemPool, random, filters);
-}
+    std::vector<ItemInfo*> sortedPool{itemPool};
+    // Items of equal value keep pool order, so picks do not depend on sort implementation
+    std::stable_sort(sortedPool.begin(), sortedPool.end(),
+                     [](const ItemInfo* a, const ItemInfo* b) {
+                         return a->getValue() < b->getValue();
+                     });
 
-ItemInfo* pickItem(RandomGenerator& random, const ItemFilterList& filters)
-{
-    return pickItem(getGameInfo()->getItems(), random, filters);
+    for (ItemInfo* item : sortedPool) {
+        const auto type{static_cast<std::size_t>(item->getItemType())};
+        assert(type < itemTypesTotal);
+
+        auto& itemsOfType{itemsByType[type]};
+        itemsOfType.values.push_back(item->getValue());
+        itemsOfType.items.push_back(item);
+    }
 }
 
-ItemInfo* pickItem(ItemType itemType, RandomGenerator& random, const ItemFilterList& filters)
+ItemInfo* ItemIndex::pick(const std::vector<ItemType>& itemTypes,
+                          int minValue,
+                          int maxValue,
+                          RandomGenerator& random) const
 {
-    return pickItem(getGameInfo()->getItems(itemType), random, filters);
+    if (minValue > maxValue) {
+        return nullptr;
+    }
+
+    // Ranges of suitable items for each of item types
+    struct Range
+    {
+        const ItemsOfType* itemsOfType;
+        std::size_t start;
+        std::size_t count;
+    };
+
+    assert(itemTypes.size() <= itemTypesTotal);
+    std::array<Range, itemTypesTotal> ranges;
+    std::size_t rangesTotal{};
+    std::size_t total{};
+
+    for (const auto& itemType : itemTypes) {
+        const auto& itemsOfType{itemsByType[static_cast<std::size_t>(itemType)]};
+        const auto& values{itemsOfType.values};
+
+        const auto begin{std::lower_bound(values.begin(), values.end(), minValue)};
+        const auto end{std::upper_bound(begin, values.end(), maxValue)};
+        if (begin == end) {
+            continue;
+        }
+
+        const auto start{static_cast<std::size_t>(begin - values.begin())};
+        const auto count{static_cast<std::size_t>(end - begin)};
+
+        ranges[rangesTotal++] = Range{&itemsOfType, start, count};
+        total += count;
+    }
+
+    if (!total) {
+        // Value range is too tight, nothing to pick
+        return nullptr;
+    }
+
+    std::size_t index{random.nextInteger(std::size_t{0}, total - 1)};
+    for (std::size_t i = 0; i < rangesTotal; ++i) {
+        const auto& range{ranges[i]};
+        if (index < range.count) {
+            return range.itemsOfType->items[range.start + index];
+        }
+
+        index -= range.count;
+    }
+
+    return nullptr;
 }
 
 bool noSpecialItem(const ItemInfo* info)
@@ -20,6 +20,7 @@
 #pragma once
 
 #include "enums.h"
+#include <array>
 #include <functional>
 #include <vector>
 
@@ -33,14 +34,33 @@ class RandomGenerator;
 using ItemFilterFunc = std::function<bool(const ItemInfo*)>;
 using ItemFilterList = std::initializer_list<ItemFilterFunc>;
 
-// Pick random item from specified pool
-ItemInfo* pickItem(const std::vector<ItemInfo*>& itemPool,
-                   RandomGenerator& random,
-                   const ItemFilterList& filters);
-// Picks any random item after applying filters
-ItemInfo* pickItem(RandomGenerator& random, const ItemFilterList& filters);
-// Picks random item of specific type
-ItemInfo* pickItem(ItemType itemType, RandomGenerator& random, const ItemFilterList& filters);
+// Items grouped by type and sorted by value.
+// Picks random item with value in range using binary searches and a single draw
+class ItemIndex
+{
+public:
+    ItemIndex() = default;
+    explicit ItemIndex(const std::vector<ItemInfo*>& itemPool);
+
+    // Picks random item of one of specified types with value in [minValue : maxValue] range.
+    // Returns nullptr if there are no such items
+    ItemInfo* pick(const std::vector<ItemType>& itemTypes,
+                   int minValue,
+                   int maxValue,
+                   RandomGenerator& random) const;
+
+private:
+    static constexpr std::size_t itemTypesTotal{static_cast<std::size_t>(ItemType::Special) + 1};
+
+    // Values are stored separately from items, so binary search does not call getValue()
+    struct ItemsOfType
+    {
+        std::vector<int> values;
+        std::vector<ItemInfo*> items;
+    };
+
+    std::array<ItemsOfType, itemTypesTotal> itemsByType;
+};
 
 // These below are predefined filters
 
@@ -19,34 +19,126 @@
 
 #include "landmarkpicker.h"
 #include "gameinfo.h"
-#include "picker.h"
+#include "position.h"
+#include "randomgenerator.h"
+#include <algorithm>
+#include <exception>
 
 namespace rsg {
 
-LandmarkInfo* pickLandmark(const std::vector<LandmarkInfo*>& landmarkPool,
-                           RandomGenerator& random,
-                           const LandmarkFilterList& filters)
+LandmarkIndex::LandmarkIndex(const GameInfo& gameInfo)
 {
-    return pick(landmarkPool, random, filters);
-}
+    // Landmarks of the same size keep their order, so picks do not depend on sort implementation
+    auto bySize = [](const LandmarkInfo* a, const LandmarkInfo* b) {
+        const auto& sizeA{a->getSize()};
+        const auto& sizeB{b->getSize()};
 
-LandmarkInfo* pickLandmark(LandmarkType landmarkType,
-                           RandomGenerator& random,
-                           const LandmarkFilterList& filters)
-{
-    return pickLandmark(getGameInfo()->getLandmarks(landmarkType), random, filters);
+        return sizeA.x < sizeB.x || (sizeA.x == sizeB.x && sizeA.y < sizeB.y);
+    };
+
+    for (std::size_t race = 0; race < racesTotal; ++race) {
+        std::vector<LandmarkInfo*> landmarks;
+
+        try {
+            landmarks = gameInfo.getLandmarks(static_cast<RaceType>(race));
+        } catch (const std::exception&) {
+            // Game info has no landmarks for this race, picks will return nullptr
+            continue;
+        }
+
+        std::stable_sort(landmarks.begin(), landmarks.end(), bySize);
+
+        for (LandmarkInfo* landmark : landmarks) {
+            const std::size_t mountain{landmark->isMountain() ? 1u : 0u};
+            const auto type{static_cast<std::size_t>(landmark->getLandmarkType())};
+            if (type >= typesTotal) {
+                continue;
+            }
+
+            auto& group{landmarksByRace[race][mountain][type]};
+            group.widths.push_back(landmark->getSize().x);
+            group.landmarks.push_back(landmark);
+        }
+    }
+
+    for (LandmarkInfo* landmark : gameInfo.getMountainLandmarks()) {
+        const auto& size{landmark->getSize()};
+        mountainsBySize[{size.x, size.y}].push_back(landmark);
+    }
 }
 
-LandmarkInfo* pickLandmark(RaceType raceType,
-                           RandomGenerator& random,
-                           const LandmarkFilterList& filters)
+LandmarkInfo* LandmarkIndex::pick(RaceType raceType,
+                                  const LandmarkConstraints& constraints,
+                                  RandomGenerator& random) const
 {
-    return pickLandmark(getGameInfo()->getLandmarks(raceType), random, filters);
+    const auto race{static_cast<std::size_t>(raceType)};
+    if (race >= racesTotal) {
+        return nullptr;
+    }
+
+    // Ranges of suitable landmarks in each group
+    struct Range
+    {
+        const LandmarksGroup* group;
+        std::size_t count;
+    };
+
+    std::array<Range, 2 * typesTotal> ranges;
+    std::size_t rangesTotal{};
+    std::size_t total{};
+
+    for (std::size_t mountain = 0; mountain < 2; ++mountain) {
+        if (mountain && !constraints.allowMountains) {
+            continue;
+        }
+
+        for (std::size_t type = 0; type < typesTotal; ++type) {
+            if (!constraints.allowMisc && static_cast<LandmarkType>(type) == LandmarkType::Misc) {
+                continue;
+            }
+
+            const auto& group{landmarksByRace[race][mountain][type]};
+            const auto& widths{group.widths};
+
+            // Groups are sorted by size, so suitable landmarks are at the start of group
+            const auto end{std::upper_bound(widths.begin(), widths.end(), constraints.maxSize)};
+            const auto count{static_cast<std::size_t>(end - widths.begin())};
+            if (!count) {
+                continue;
+            }
+
+            ranges[rangesTotal++] = Range{&group, count};
+            total += count;
+        }
+    }
+
+    if (!total) {
+        // Constraints are too tight, nothing to pick
+        return nullptr;
+    }
+
+    std::size_t index{random.nextInteger(std::size_t{0}, total - 1)};
+    for (std::size_t i = 0; i < rangesTotal; ++i) {
+        const auto& range{ranges[i]};
+        if (index < range.count) {
+            return range.group->landmarks[index];
+        }
+
+        index -= range.count;
+    }
+
+    return nullptr;
 }
 
-LandmarkInfo* pickMountainLandmark(RandomGenerator& random, const LandmarkFilterList& filters)
+LandmarkInfo* LandmarkIndex::pickMountain(int sizeX, int sizeY, RandomGenerator& random) const
 {
-    return pickLandmark(getGameInfo()->getMountainLandmarks(), random, filters);
+    const auto it{mountainsBySize.find({sizeX, sizeY})};
+    if (it == mountainsBySize.end()) {
+        return nullptr;
+    }
+
+    const auto& mountains{it->second};
+    return mountains[random.nextInteger(std::size_t{0}, mountains.size() - 1)];
 }
 
 } // namespace rsg
@@ -20,32 +20,61 @@
 #pragma once
 
 #include "enums.h"
-#include <functional>
+#include <array>
+#include <limits>
+#include <map>
+#include <utility>
 #include <vector>
 
 namespace rsg {
 
+class GameInfo;
 class LandmarkInfo;
 class RandomGenerator;
 
-// Filter that decides whether landmark should be discarded from pick or not.
-// Returns true for landmark that should be removed from pick pool
-using LandmarkFilterFunc = std::function<bool(const LandmarkInfo*)>;
-using LandmarkFilterList = std::initializer_list<LandmarkFilterFunc>;
-
-// Pick random landmark from specified pool
-LandmarkInfo* pickLandmark(const std::vector<LandmarkInfo*>& landmarkPool,
-                           RandomGenerator& random,
-                           const LandmarkFilterList& filters);
-// Pick random landmark of specified type
-LandmarkInfo* pickLandmark(LandmarkType landmarkType,
-                           RandomGenerator& random,
-                           const LandmarkFilterList& filters);
-// Pick random landmark visually appropriate for specified race
-LandmarkInfo* pickLandmark(RaceType raceType,
-                           RandomGenerator& random,
-                           const LandmarkFilterList& filters);
-// Pick random mountain landmark
-LandmarkInfo* pickMountainLandmark(RandomGenerator& random, const LandmarkFilterList& filters);
+// Landmark properties allowed for pick
+struct LandmarkConstraints
+{
+    int maxSize{std::numeric_limits<int>::max()}; // Maximum landmark width
+    bool allowMountains{true}; // Allow landmarks that do not allow terrain spread
+    bool allowMisc{true};      // Allow landmarks of LandmarkType::Misc
+};
+
+// Landmarks grouped by race, mountain flag and type, each group sorted by size.
+// Mountain landmarks are grouped by size.
+// Picks random landmark with binary searches and a single draw
+class LandmarkIndex
+{
+public:
+    LandmarkIndex() = default;
+    explicit LandmarkIndex(const GameInfo& gameInfo);
+
+    // Picks random landmark visually appropriate for specified race.
+    // Returns nullptr if there are no landmarks satisfying constraints
+    LandmarkInfo* pick(RaceType raceType,
+                       const LandmarkConstraints& constraints,
+                       RandomGenerator& random) const;
+
+    // Picks random mountain landmark of specified size.
+    // Returns nullptr if there are no such landmarks
+    LandmarkInfo* pickMountain(int sizeX, int sizeY, RandomGenerator& random) const;
+
+private:
+    static constexpr std::size_t racesTotal{static_cast<std::size_t>(RaceType::Elf) + 1};
+    static constexpr std::size_t typesTotal{static_cast<std::size_t>(LandmarkType::Terrain) + 1};
+
+    // Widths are stored separately from landmarks, so binary search does not call getSize()
+    struct LandmarksGroup
+    {
+        std::vector<int> widths;
+        std::vector<LandmarkInfo*> landmarks;
+    };
+
+    // Groups of landmarks without and with mountain flag
+    using LandmarksOfRace = std::array<std::array<LandmarksGroup, typesTotal>, 2>;
+
+    std::array<LandmarksOfRace, racesTotal> landmarksByRace;
+    std::map<std::pair<int, int> /* size */, std::vector<LandmarkInfo*>> mountainsBySize;
+};
 
 } // namespace rsg
@@ -18,24 +18,48 @@
  */
 
 #include "mapgenerator.h"
+#include "containers.h"
+#include "decoration.h"
 #include "diplomacy.h"
 #include "fog.h"
 #include "image.h"
+#include "itempicker.h"
 #include "knownspells.h"
 #include "maptemplate.h"
+#include "picker.h"
 #include "player.h"
 #include "playerbuildings.h"
 #include "road.h"
 #include "scenarioinfo.h"
+#include "spellpicker.h"
 #include "subrace.h"
+#include "threadpool.h"
+#include "unitpicker.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <numeric>
 #include <sstream>
 #include <stdexcept>
+#include <thread>
 
 namespace rsg {
 
+// Independent random streams of generation steps.
+// Steps do not affect random values of each other
+enum class RandomStream : std::uint64_t
+{
+    ZonePlacement,
+    Zones,
+    Connections,
+    Roads,
+};
+
+static RandomGenerator forkStream(const RandomGenerator& random, RandomStream stream)
+{
+    return random.fork(static_cast<std::uint64_t>(stream));
+}
+
 PlayerSubraceIdPair MapGenerator::createPlayer(RaceType race)
 {
     auto playerId{createId(CMidgardID::Type::Player)};
@@ -94,6 +118,8 @@ MapPtr MapGenerator::generate()
 
     addHeaderInfo();
     initTiles();
+    initMountains();
+    initPickPools();
 
     // Create neutral player first
     auto playerSubraceIds{createPlayer(RaceType::Neutral)};
@@ -107,6 +133,18 @@ MapPtr MapGenerator::generate()
 
     setupDiplomacy();
 
+    if (isDebugMode()) {
+        std::size_t searches{};
+        std::size_t expandedTiles{};
+        for (const auto& it : zones) {
+            searches += it.second->getPathfinder().getTotalSearches();
+            expandedTiles += it.second->getPathfinder().getTotalExpandedTiles();
+        }
+
+        std::cout << "Path searches: " << searches << ", tiles expanded: " << expandedTiles
+                  << '\n';
+    }
+
     return std::move(map);
 }
 
@@ -134,9 +172,73 @@ void MapGenerator::initTiles()
 {
     map->initTerrain(); // TODO
 
-    const auto total{map->size * map->size};
-    tiles.resize(total);
-    zoneColoring.resize(total);
+    tiles.resize(map->size);
+}
+
+void MapGenerator::initMountains()
+{
+    std::map<int /* mountain size */, MountainsVector> mountains;
+    for (const auto& mountain : getGeneratorSettings().mountains) {
+        mountains[mountain.size].push_back(mountain);
+    }
+
+    // Bigger mountains first
+    mountainsBySize.assign(mountains.rbegin(), mountains.rend());
+}
+
+void MapGenerator::initPickPools()
+{
+    const auto& settings{mapGenOptions.mapTemplate->settings};
+
+    auto noForbiddenUnitOnTemplate = [&settings](const UnitInfo* info) {
+        return contains(settings.forbiddenUnits, info->getUnitId());
+    };
+
+    auto noForbiddenItemOnTemplate = [&settings](const ItemInfo* info) {
+        return contains(settings.forbiddenItems, info->getItemId());
+    };
+
+    auto noForbiddenSpellOnTemplate = [&settings](const SpellInfo* info) {
+        return contains(settings.forbiddenSpells, info->getSpellId());
+    };
+
+    const UnitFilterList unitFilters{noForbiddenUnitOnTemplate, noForbiddenUnit};
+    pickPools.leaders = UnitIndex{filterPool(getGameInfo()->getLeaders(), unitFilters)};
+    pickPools.soldiers = UnitIndex{filterPool(getGameInfo()->getSoldiers(), unitFilters)};
+
+    const ItemFilterList itemFilters{noSpecialItem, noForbiddenItemOnTemplate, noForbiddenItem};
+    pickPools.items = ItemIndex{filterPool(getGameInfo()->getItems(), itemFilters)};
+
+    const SpellFilterList spellFilters{noForbiddenSpellOnTemplate, noForbiddenSpell};
+    pickPools.spells = filterPool(getGameInfo()->getSpells(), spellFilters);
+
+    pickPools.landmarks = LandmarkIndex{*getGameInfo()};
+}
+
+const StackCompositions& MapGenerator::getStackCompositions(
+    const std::set<SubRaceType>& subraces,
+    int maxValue)
+{
+    // Stacks with close maximum values share tables
+    constexpr int valueBucketSize{1024};
+    const int bucket{std::max(0, maxValue) / valueBucketSize};
+
+    StackCompositionsEntry* entry{};
+    {
+        std::lock_guard<std::mutex> lock(stackCompositionsMutex);
+        // Map nodes are not moved on insertion, so entry pointer stays valid
+        entry = &stackCompositions[std::make_pair(bucket, subraces)];
+    }
+
+    // Table is built outside of the lock, zones that need other tables do not wait for it
+    std::call_once(entry->built, [this, entry, bucket, &subraces]() {
+        // Forbidden units are already excluded from pick pools
+        entry->compositions = std::make_unique<StackCompositions>(
+            pickPools.leaders.getUnits(subraces), pickPools.soldiers.getUnits(subraces),
+            (bucket + 1) * valueBucketSize - 1);
+    });
+
+    return *entry->compositions;
 }
 
 void MapGenerator::generateZones()
@@ -154,7 +256,8 @@ void MapGenerator::generateZones()
     }
 
     ZonePlacer placer(this);
-    placer.placeZones(&randomGenerator);
+    RandomGenerator placementRandom{forkStream(randomGenerator, RandomStream::ZonePlacement)};
+    placer.placeZones(&placementRandom);
     placer.assignZones();
 
     if (isDebugMode()) {
@@ -181,24 +284,44 @@ void MapGenerator::fillZones()
         }
     }
 
+    // Zones create objects with their own random sequences and identifiers,
+    // so generated scenario does not depend on the number of threads.
+    // Zone that uses up its identifiers of some type reserves more of them from the map,
+    // only then identifiers depend on the order in which zones ran out of them
+    const int idsPerZone{std::min(2048, 32768 / std::max(1, static_cast<int>(zones.size())))};
+    const RandomGenerator zonesRandom{forkStream(randomGenerator, RandomStream::Zones)};
     for (auto& it : zones) {
-        it.second->initTowns();
+        it.second->prepare(zonesRandom.fork(static_cast<std::uint64_t>(it.first)),
+                           map->reserveIds(idsPerZone));
     }
 
-    // Make sure there are some free tiles in the zone
-    for (auto& it : zones) {
-        it.second->initFreeTiles();
+    createZoneWaves();
+
+    std::size_t largestWave{1};
+    for (const auto& wave : zoneWaves) {
+        largestWave = std::max(largestWave, wave.size());
     }
 
-    for (auto& it : zones) {
-        it.second->createBorder();
+    std::size_t threadsTotal{1};
+    // Keep debug output in order
+    if (!isDebugMode()) {
+        threadsTotal = mapGenOptions.threads > 0
+                           ? static_cast<std::size_t>(mapGenOptions.threads)
+                           : std::max(1u, std::thread::hardware_concurrency());
     }
 
+    ThreadPool pool{std::min(threadsTotal, largestWave)};
+
+    runZoneTasks(pool, ZonePhase::Towns, [](TemplateZone& zone) { zone.initTowns(); });
+    // Make sure there are some free tiles in the zone
+    runZoneTasks(pool, ZonePhase::FreeTiles, [](TemplateZone& zone) { zone.initFreeTiles(); });
+    runZoneTasks(pool, ZonePhase::Border, [](TemplateZone& zone) { zone.createBorder(); });
+
+    startZonePhase(ZonePhase::Connections);
     createDirectConnections();
+    commitZoneObjects();
 
-    for (auto& it : zones) {
-        it.second->fill();
-    }
+    runZoneTasks(pool, ZonePhase::Fill, [](TemplateZone& zone) { zone.fill(); });
 
     constexpr bool debugObstacles{false};
 
@@ -217,17 +340,13 @@ void MapGenerator::fillZones()
     // but as a loop through all possible tiles.
     // In this case mountains on zone boundaries can be made bigger.
     // Place actual obstacles matching zone terrain
-    for (auto& it : zones) {
-        it.second->createObstacles();
-    }
+    runZoneTasks(pool, ZonePhase::Obstacles, [](TemplateZone& zone) { zone.createObstacles(); });
 
     if constexpr (debugObstacles) {
         debugTiles("after createObstacles in zones.png");
     }
 
-    for (auto& it : zones) {
-        it.second->connectRoads();
-    }
+    runZoneTasks(pool, ZonePhase::Roads, [](TemplateZone& zone) { zone.connectRoads(); });
 
     createRoads();
 }
@@ -272,6 +391,8 @@ void MapGenerator::setupDiplomacy()
 
 void MapGenerator::createDirectConnections()
 {
+    RandomGenerator random{forkStream(randomGenerator, RandomStream::Connections)};
+
     for (auto& connection : mapGenOptions.mapTemplate->contents.connections) {
         auto zoneA{zones[connection.zoneFrom]};
         auto zoneB{zones[connection.zoneTo]};
@@ -299,11 +420,13 @@ void MapGenerator::createDirectConnections()
         auto middleTile{std::accumulate(middleTiles.begin(), middleTiles.end(), Position(0, 0))};
         middleTile /= tilesCount;
 
-        std::sort(middleTiles.begin(), middleTiles.end(),
-                  [&middleTile](const Position& a, Position& b) {
-                      // Choose tiles with both coordinates in the middle
-                      return a.mahnattanDistance(middleTile) < b.mahnattanDistance(middleTile);
-                  });
+        // Stable sort keeps order of tiles with the same distance on all platforms
+        std::stable_sort(middleTiles.begin(), middleTiles.end(),
+                         [&middleTile](const Position& a, const Position& b) {
+                             // Choose tiles with both coordinates in the middle
+                             return a.mahnattanDistance(middleTile)
+                                    < b.mahnattanDistance(middleTile);
+                         });
 
         // Remove 1/4 tiles from each side - path should cross zone borders at smooth angle
         const auto removeCount{tilesCount / 4};
@@ -311,7 +434,7 @@ void MapGenerator::createDirectConnections()
         middleTiles.erase(middleTiles.end() - removeCount, middleTiles.end());
         middleTiles.erase(middleTiles.begin(), middleTiles.begin() + removeCount);
 
-        randomShuffle(middleTiles, randomGenerator);
+        randomShuffle(middleTiles, random);
 
         for (auto& tile : middleTiles) {
             guardPos = tile;
@@ -341,41 +464,313 @@ void MapGenerator::createDirectConnections()
     }
 }
 
+void MapGenerator::createZoneWaves()
+{
+    // Zones change tiles outside of their own area: decorations are placed around objects,
+    // fortification entrances are cleared with their neighbors
+    // and mountains started at zone tiles spread to the right and down.
+    // Zones that can reach the same tile are never filled at the same time
+    const auto& mountains{getMountainsBySize()};
+    const int mountainReach{mountains.empty() ? 0 : mountains.front().first - 1};
+    const int zoneReach{
+        std::max({Decoration::maxGapSize, TemplateZone::entranceReach, mountainReach})};
+    const int conflictDistance{zoneReach * 2};
+
+    std::vector<TemplateZone*> zonesList;
+    std::map<TemplateZoneId, std::size_t> zoneIndices;
+    for (auto& it : zones) {
+        zoneIndices[it.first] = zonesList.size();
+        zonesList.push_back(it.second.get());
+    }
+
+    const std::size_t total{zonesList.size()};
+    const int size{map->size};
+
+    // Index of zone for each tile, 'total' for tiles without zone
+    std::vector<std::size_t> tileZones(static_cast<std::size_t>(size * size), total);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            auto it{zoneIndices.find(tiles.getZoneId(tiles.toIndex(x, y)))};
+            if (it != zoneIndices.end()) {
+                tileZones[x + y * size] = it->second;
+            }
+        }
+    }
+
+    // Path from any tile of a zone to a tile outside of it leaves the zone through its border,
+    // so it is enough to look around border tiles
+    std::vector<std::uint8_t> conflicts(total * total);
+    for (int y = 0; y < size; ++y) {
+        for (int x = 0; x < size; ++x) {
+            const auto zone{tileZones[x + y * size]};
+            if (zone == total) {
+                continue;
+            }
+
+            bool border{};
+            for (int dy = std::max(0, y - 1); dy <= std::min(size - 1, y + 1) && !border; ++dy) {
+                for (int dx = std::max(0, x - 1); dx <= std::min(size - 1, x + 1); ++dx) {
+                    if (tileZones[dx + dy * size] != zone) {
+                        border = true;
+                        break;
+                    }
+                }
+            }
+
+            if (!border) {
+                continue;
+            }
+
+            const int top{std::max(0, y - conflictDistance)};
+            const int bottom{std::min(size - 1, y + conflictDistance)};
+            const int left{std::max(0, x - conflictDistance)};
+            const int right{std::min(size - 1, x + conflictDistance)};
+
+            for (int ty = top; ty <= bottom; ++ty) {
+                for (int tx = left; tx <= right; ++tx) {
+                    const auto other{tileZones[tx + ty * size]};
+                    if (other != zone && other != total) {
+                        conflicts[zone * total + other] = 1;
+                        conflicts[other * total + zone] = 1;
+                    }
+                }
+            }
+        }
+    }
+
+    // Greedy coloring in order of zone ids keeps waves the same between runs
+    std::vector<std::vector<std::size_t>> waves;
+    for (std::size_t i = 0; i < total; ++i) {
+        auto wave{std::find_if(waves.begin(), waves.end(), [&conflicts, total, i](const auto& w) {
+            return std::none_of(w.begin(), w.end(), [&conflicts, total, i](std::size_t zone) {
+                return conflicts[zone * total + i] != 0;
+            });
+        })};
+
+        if (wave == waves.end()) {
+            wave = waves.emplace(waves.end());
+        }
+
+        wave->push_back(i);
+    }
+
+    zoneWaves.clear();
+    for (const auto& wave : waves) {
+        auto& zoneWave{zoneWaves.emplace_back()};
+
+        for (auto index : wave) {
+            zoneWave.push_back(zonesList[index]);
+        }
+    }
+
+    if (isDebugMode()) {
+        std::cout << "Zones are filled in " << zoneWaves.size() << " waves\n";
+    }
+}
+
+void MapGenerator::startZonePhase(ZonePhase phase)
+{
+    for (auto& it : zones) {
+        it.second->startPhase(phase);
+    }
+}
+
+void MapGenerator::runZoneTasks(ThreadPool& pool,
+                                ZonePhase phase,
+                                const std::function<void(TemplateZone&)>& task)
+{
+    startZonePhase(phase);
+
+    // Zones of the same wave are far from each other and can be processed at the same time
+    for (const auto& wave : zoneWaves) {
+        pool.run(wave.size(), [&wave, &task](std::size_t index) { task(*wave[index]); });
+    }
+
+    commitZoneObjects();
+}
+
+void MapGenerator::commitZoneObjects()
+{
+    for (auto& it : zones) {
+        it.second->commitObjects();
+    }
+}
+
+// Number of tiles stored in a single word of map column
+static constexpr int columnWordBits{64};
+
+// Returns mask of bits with indices not less than specified one
+static std::uint64_t getBitsStartingFrom(int index)
+{
+    if (index <= 0) {
+        return ~std::uint64_t{0};
+    }
+
+    if (index >= columnWordBits) {
+        return 0;
+    }
+
+    return ~std::uint64_t{0} << index;
+}
+
+static int lowestBitIndex(std::uint64_t value)
+{
+    int index{};
+    while (!(value & 1)) {
+        value >>= 1;
+        ++index;
+    }
+
+    return index;
+}
+
+// Returns bits of column word with previous tile (y - 1) states
+static std::uint64_t getPreviousTiles(const std::uint64_t* column, int word)
+{
+    const auto carry{word > 0 ? column[word - 1] >> (columnWordBits - 1) : 0};
+    return (column[word] << 1) | carry;
+}
+
+// Returns bits of column word with next tile (y + 1) states
+static std::uint64_t getNextTiles(const std::uint64_t* column, int word, int words)
+{
+    const auto carry{word + 1 < words ? column[word + 1] << (columnWordBits - 1) : 0};
+    return (column[word] >> 1) | carry;
+}
+
+// Returns mask of column word tiles that have more than 4 of 8 neighbors set in plane.
+// Neighbors are counted in parallel for all bits using bit-sliced adders
+static std::uint64_t findMoreThanFour(const std::vector<std::uint64_t>& plane,
+                                      std::size_t column,
+                                      int word,
+                                      int words)
+{
+    const auto* left{&plane[column - words]};
+    const auto* center{&plane[column]};
+    const auto* right{&plane[column + words]};
+
+    const std::uint64_t a{getPreviousTiles(left, word)};
+    const std::uint64_t b{left[word]};
+    const std::uint64_t c{getNextTiles(left, word, words)};
+    const std::uint64_t d{getPreviousTiles(center, word)};
+    const std::uint64_t e{getNextTiles(center, word, words)};
+    const std::uint64_t f{getPreviousTiles(right, word)};
+    const std::uint64_t g{right[word]};
+    const std::uint64_t h{getNextTiles(right, word, words)};
+
+    // Full adders for a, b, c and d, e, f, half adder for g, h
+    const auto sum1{a ^ b ^ c};
+    const auto carry1{(a & b) | (c & (a ^ b))};
+    const auto sum2{d ^ e ^ f};
+    const auto carry2{(d & e) | (f & (d ^ e))};
+    const auto sum3{g ^ h};
+    const auto carry3{g & h};
+
+    // Ones of the count
+    const auto ones{sum1 ^ sum2 ^ sum3};
+    const auto carry4{(sum1 & sum2) | (sum3 & (sum1 ^ sum2))};
+
+    // Twos: add carries of weight 2
+    const auto sum5{carry1 ^ carry2 ^ carry3};
+    const auto carry5{(carry1 & carry2) | (carry3 & (carry1 ^ carry2))};
+    const auto twos{sum5 ^ carry4};
+    const auto carry6{sum5 & carry4};
+
+    // Fours and eights
+    const auto fours{carry5 ^ carry6};
+    const auto eights{carry5 & carry6};
+
+    // Count is 5 or more
+    return eights | (fours & (twos | ones));
+}
+
 void MapGenerator::createObstacles()
 {
+    // Tile states are stored as bits of map columns, bit index is tile y coordinate.
+    // Extra empty columns at both sides and unused bits of last words
+    // stand for tiles outside of the map, they are neither blocked nor free
+    const int size{map->size};
+    const int words{(size + columnWordBits - 1) / columnWordBits};
+    const auto total{static_cast<std::size_t>(size + 2) * words};
+
+    std::vector<std::uint64_t> blocked(total, 0);
+    std::vector<std::uint64_t> free(total, 0);
+    std::vector<std::uint64_t> possible(total, 0);
+
+    auto getBit = [words](int x, int y) {
+        return static_cast<std::size_t>(x + 1) * words + y / columnWordBits;
+    };
+
+    for (int x = 0; x < size; ++x) {
+        for (int y = 0; y < size; ++y) {
+            const std::size_t tile{tiles.toIndex(x, y)};
+            const auto bit{std::uint64_t{1} << (y % columnWordBits)};
+
+            if (tiles.isBlocked(tile)) {
+                blocked[getBit(x, y)] |= bit;
+            } else if (tiles.isFree(tile)) {
+                free[getBit(x, y)] |= bit;
+            } else if (tiles.isPossible(tile)) {
+                possible[getBit(x, y)] |= bit;
+            }
+        }
+    }
+
     // Tighten obstacles to improve visuals
     for (int i = 0; i < 3; ++i) {
         int blockedTiles{};
         int freeTiles{};
 
-        for (int x = 0; x < map->size; ++x) {
-            for (int y = 0; y < map->size; ++y) {
-                const Position tile{x, y};
-                // Only possible tiles can be changed
-                if (!isPossible(tile)) {
-                    continue;
+        // Tiles are updated in place, column by column from top to bottom,
+        // so each tile sees new states of previous tiles and old states of the next ones.
+        // Whole column is checked at once, only the first changed tile is accepted.
+        // Its change affects the next tile, so column is checked again below it
+        for (int x = 0; x < size; ++x) {
+            const auto column{static_cast<std::size_t>(x + 1) * words};
+            int first{};
+
+            while (first < size) {
+                int changedY{-1};
+                bool becameBlocked{};
+
+                for (int w = first / columnWordBits; w < words; ++w) {
+                    const auto blockedNeighbors{findMoreThanFour(blocked, column, w, words)};
+                    const auto freeNeighbors{findMoreThanFour(free, column, w, words)};
+
+                    // Only possible tiles can be changed
+                    const auto candidates{possible[column + w]
+                                          & getBitsStartingFrom(first - w * columnWordBits)};
+                    const auto toBlock{candidates & blockedNeighbors};
+                    const auto toFree{candidates & ~blockedNeighbors & freeNeighbors};
+
+                    if (toBlock | toFree) {
+                        const auto bit{lowestBitIndex(toBlock | toFree)};
+
+                        changedY = w * columnWordBits + bit;
+                        becameBlocked = (toBlock >> bit) & 1;
+                        break;
+                    }
                 }
 
-                int blockedNeighbors{};
-                int freeNeighbors{};
-                foreachNeighbor(tile,
-                                [this, &blockedNeighbors, &freeNeighbors](Position& position) {
-                                    if (isBlocked(position)) {
-                                        ++blockedNeighbors;
-                                    }
-
-                                    if (isFree(position)) {
-                                        ++freeNeighbors;
-                                    }
-                                });
-
-                if (blockedNeighbors > 4) {
-                    setOccupied(tile, TileType::Blocked);
+                if (changedY == -1) {
+                    break;
+                }
+
+                const auto bit{std::uint64_t{1} << (changedY % columnWordBits)};
+                const auto word{getBit(x, changedY)};
+
+                possible[word] &= ~bit;
+                if (becameBlocked) {
+                    blocked[word] |= bit;
+                    tiles.setOccupied(tiles.toIndex(x, changedY), TileType::Blocked);
                     ++blockedTiles;
-                } else if (freeNeighbors > 4) {
-                    setOccupied(tile, TileType::Free);
+                } else {
+                    free[word] |= bit;
+                    tiles.setOccupied(tiles.toIndex(x, changedY), TileType::Free);
                     ++freeTiles;
                 }
+
+                first = changedY + 1;
             }
         }
 
@@ -390,148 +785,92 @@ TemplateZoneId MapGenerator::getZoneId(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return zoneColoring[posToIndex(position)];
+    return tiles.getZoneId(posToIndex(position));
 }
 
 void MapGenerator::setZoneId(const Position& position, TemplateZoneId zoneId)
 {
     checkIsOnMap(position);
 
-    zoneColoring[posToIndex(position)] = zoneId;
+    tiles.setZoneId(posToIndex(position), zoneId);
 }
 
-void MapGenerator::checkIsOnMap(const Position& position) const
+void MapGenerator::reportNotOnMap(const Position& position) const
 {
-    if (!map->isInTheMap(position)) {
-        std::stringstream stream;
-        stream << "Tile " << position << " is outside the map";
+    std::stringstream stream;
+    stream << "Tile " << position << " is outside the map";
 
-        throw std::runtime_error(stream.str());
-    }
+    throw std::runtime_error(stream.str());
 }
 
 bool MapGenerator::isBlocked(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)].isBlocked();
+    return tiles.isBlocked(posToIndex(position));
 }
 
 bool MapGenerator::shouldBeBlocked(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)].shouldBeBlocked();
+    return tiles.shouldBeBlocked(posToIndex(position));
 }
 
 bool MapGenerator::isPossible(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)].isPossible();
+    return tiles.isPossible(posToIndex(position));
 }
 
 bool MapGenerator::isFree(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)].isFree();
+    return tiles.isFree(posToIndex(position));
 }
 
 bool MapGenerator::isUsed(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)].isUsed();
+    return tiles.isUsed(posToIndex(position));
 }
 
 bool MapGenerator::isRoad(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)].isRoad();
+    return tiles.isRoad(posToIndex(position));
 }
 
 void MapGenerator::setOccupied(const Position& position, TileType value)
 {
     checkIsOnMap(position);
 
-    tiles[posToIndex(position)].setOccupied(value);
+    tiles.setOccupied(posToIndex(position), value);
 }
 
 void MapGenerator::setRoad(const Position& position, bool value)
 {
     checkIsOnMap(position);
 
-    tiles[posToIndex(position)].setRoad(value);
-}
-
-void MapGenerator::foreachNeighbor(const Position& position, std::function<void(Position&)> f)
-{
-    for (const auto& direction : Position::getDirections()) {
-        Position p{position + direction};
-
-        if (map->isInTheMap(p)) {
-            f(p);
-        }
-    }
-}
-
-void MapGenerator::foreachDirectNeighbor(const Position& position, std::function<void(Position&)> f)
-{
-    // Directions are set clockwise, starting from north
-    // This is important for road incides!
-    // clang-format off
-    static const std::array<Position, 4> directions{{
-        Position{ 0, -1},
-        Position{ 1,  0},
-        Position{ 0,  1},
-        Position{-1,  0}
-    }};
-    // clang-format on
-
-    for (const auto& direction : directions) {
-        Position p{position + direction};
-
-        if (map->isInTheMap(p)) {
-            f(p);
-        }
-    }
-}
-
-void MapGenerator::foreachDiagonalNeighbor(const Position& position,
-                                           std::function<void(Position&)> f)
-{
-    // clang-format off
-    static const std::array<Position, 4> directions{{
-        Position{-1, -1},
-        Position{ 1, -1},
-        Position{-1, 1},
-        Position{ 1, 1}
-    }};
-    // clang-format on
-
-    for (const auto& direction : directions) {
-        Position p{position + direction};
-
-        if (map->isInTheMap(p)) {
-            f(p);
-        }
-    }
+    tiles.setRoad(posToIndex(position), value);
 }
 
 float MapGenerator::getNearestObjectDistance(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)].getNearestObjectDistance();
+    return tiles.getNearestObjectDistance(posToIndex(position));
 }
 
 void MapGenerator::setNearestObjectDistance(const Position& position, float value)
 {
     checkIsOnMap(position);
 
-    tiles[posToIndex(position)].setNearestObjectDistance(value);
+    tiles.setNearestObjectDistance(posToIndex(position), value);
 }
 
 void MapGenerator::createRoads()
@@ -542,58 +881,52 @@ void MapGenerator::createRoads()
         return;
     }
 
-    std::set<Position> roads;
+    RandomGenerator random{forkStream(randomGenerator, RandomStream::Roads)};
+
+    // Tiles where road objects will be created
+    std::vector<std::uint8_t> roads(tiles.getTotalTiles(), 0);
 
     for (const auto& it : zones) {
         const auto& zoneRoads{it.second->getRoads()};
 
         for (const auto& roadInfo : zoneRoads) {
-            auto path{roadInfo.path};
+            const auto& path{roadInfo.path};
 
             if (roadsPercentage == 100) {
                 // All road tiles contains roads
-                while (!path.empty()) {
-                    auto node{path.top()};
-                    path.pop();
-
-                    roads.insert(node.first);
+                for (const auto index : path) {
+                    roads[index] = 1;
                 }
             } else {
                 // Create roads with gaps that looks nice.
                 // Split road into several parts and place gap tiles between each part.
                 // Choose sizes of road parts and gaps randomly.
-                const auto roadLength{roadInfo.path.size()};
+                const auto roadLength{path.size()};
 
                 const int roadTiles = roadLength * roadsPercentage / 100;
                 const int emptyTiles = roadLength - roadTiles;
                 // 1 gap in the road for each 10 tiles
                 const int gaps{std::max<int>(1, roadLength / 10)};
 
-                const auto gapSizes{constrainedSum(gaps, emptyTiles, randomGenerator)};
-                const auto partsSizes{constrainedSum(gaps + 1, roadTiles, randomGenerator)};
+                const auto gapSizes{constrainedSum(gaps, emptyTiles, random)};
+                const auto partsSizes{constrainedSum(gaps + 1, roadTiles, random)};
 
-                std::size_t index{};
+                std::size_t offset{};
 
-                for (std::size_t i = 0; i < partsSizes.size() && !path.empty(); ++i) {
-                    const auto partSize{partsSizes[i]};
+                for (std::size_t i = 0; i < partsSizes.size() && offset < roadLength; ++i) {
                     // Remember road parts
-                    for (std::size_t j = 0; j < partSize; ++j) {
-                        auto node{path.top()};
-                        path.pop();
-
-                        roads.insert(node.first);
+                    const auto partEnd{std::min(roadLength, offset + partsSizes[i])};
+                    for (; offset < partEnd; ++offset) {
+                        roads[path[offset]] = 1;
                     }
 
                     // Throw out gap tiles
                     if (i < gapSizes.size()) {
-                        const auto gapSize{gapSizes[i]};
-
-                        for (std::size_t j = 0; j < gapSize; ++j) {
-                            auto node{path.top()};
+                        const auto gapEnd{std::min(roadLength, offset + gapSizes[i])};
+                        for (; offset < gapEnd; ++offset) {
                             // Unmark tile, so createRoad() will not treat it
                             // as road when picking road image
-                            setRoad(node.first, false);
-                            path.pop();
+                            tiles.setRoad(path[offset], false);
                         }
                     }
                 }
@@ -604,29 +937,27 @@ void MapGenerator::createRoads()
     createRoadObjects(roads);
 }
 
-void MapGenerator::createRoadObjects(const std::set<Position>& roads)
+void MapGenerator::createRoadObjects(const std::vector<std::uint8_t>& roads)
 {
-    for (const auto& tile : roads) {
-        std::size_t index{};
-        int i{};
+    const auto& offsets{tiles.getDirectNeighborOffsets()};
 
-        // clang-format off
-        static const std::array<Position, 4> directions{{
-            Position{ 0, -1},
-            Position{ 1,  0},
-            Position{ 0,  1},
-            Position{-1,  0}
-        }};
-        // clang-format on
+    // Grid indices follow rows, so roads are created in the same order as positions are sorted
+    for (std::size_t tileIndex = 0; tileIndex < roads.size(); ++tileIndex) {
+        if (!roads[tileIndex]) {
+            continue;
+        }
+
+        const auto tile{tiles.toPosition(tileIndex)};
+        std::size_t index{};
 
-        for (const auto& direction : directions) {
-            Position p{tile + direction};
+        // Offsets follow directions clockwise starting from north
+        for (std::size_t i = 0; i < offsets.size(); ++i) {
+            const std::size_t neighbor{tileIndex + offsets[i]};
 
-            if (map->isInTheMap(p) && !map->getTile(p).isWater() && isRoad(p)) {
+            // Sentinel tiles never have roads
+            if (tiles.isRoad(neighbor) && !map->getTile(tiles.toPosition(neighbor)).isWater()) {
                 index |= 1 << i;
             }
-
-            ++i;
         }
 
         // clang-format off
@@ -669,7 +1000,7 @@ void MapGenerator::createRoadObjects(const std::set<Position>& roads)
 
         road->setPosition(tile);
         // Mark road tile as used
-        setOccupied(tile, TileType::Used);
+        tiles.setOccupied(tileIndex, TileType::Used);
 
         map->insertMapElement(*road.get(), road->getId());
         // Store object in scenario map
@@ -699,6 +1030,8 @@ CMidgardID MapGenerator::getSubraceId(RaceType race) const
 
 void MapGenerator::registerZone(RaceType race)
 {
+    std::lock_guard<std::mutex> lock{zonesMutex};
+
     zonesPerRace[race]++;
     zonesTotal++;
 }
@@ -713,18 +1046,11 @@ std::size_t MapGenerator::getTotalZoneCount() const
     return zonesTotal;
 }
 
-const TileInfo& MapGenerator::getTile(const Position& position) const
-{
-    checkIsOnMap(position);
-
-    return tiles[posToIndex(position)];
-}
-
-TileInfo& MapGenerator::getTile(const Position& position)
+TileInfo MapGenerator::getTile(const Position& position) const
 {
     checkIsOnMap(position);
 
-    return tiles[posToIndex(position)];
+    return tiles.getTileInfo(posToIndex(position));
 }
 
 void MapGenerator::debugTiles(const char* fileName) const
@@ -735,7 +1061,7 @@ void MapGenerator::debugTiles(const char* fileName) const
     for (int i = 0; i < mapSize; ++i) {
         for (int j = 0; j < mapSize; ++j) {
             const std::size_t index = i + mapSize * j;
-            const auto& tile{getTile({i, j})};
+            const auto tile{getTile({i, j})};
 
             if (tile.isRoad()) {
                 pixels[index] = RgbColor(175, 175, 175); // grey
@@ -20,19 +20,54 @@
 #pragma once
 
 #include "gameinfo.h"
+#include "generatorsettings.h"
+#include "itempicker.h"
+#include "landmarkpicker.h"
 #include "randomgenerator.h"
 #include "scenario/item.h"
 #include "scenario/map.h"
+#include "tilegrid.h"
 #include "tileinfo.h"
+#include "unitpicker.h"
 #include "zoneplacer.h"
+#include <array>
 #include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <type_traits>
 #include <vector>
 
 namespace rsg {
 
 using PlayerSubraceIdPair = std::pair<CMidgardID /* player id */, CMidgardID /* subrace id */>;
+// Known mountains of the same size
+using MountainsVector = std::vector<GeneratorSettings::Mountain>;
+using MountainsBySize = std::vector<std::pair<int /* mountain size */, MountainsVector>>;
 
 struct MapTemplate;
+class ThreadPool;
+
+// Units, items and spells that are not forbidden by generator settings and map template,
+// and landmarks indexed for decorations.
+// Built once per generation, so picks check only filters that depend on pick arguments
+struct PickPools
+{
+    UnitIndex leaders;
+    UnitIndex soldiers;
+    ItemIndex items; // Special items are excluded
+    SpellInfoArray spells;
+    LandmarkIndex landmarks;
+};
+
+// Stack compositions of one value bucket and subrace set.
+// Built by the first zone that asks for them, only zones that need the same table wait
+struct StackCompositionsEntry
+{
+    std::once_flag built;
+    std::unique_ptr<StackCompositions> compositions;
+};
 
 // Map generator options
 struct MapGenOptions
@@ -43,6 +78,7 @@ struct MapGenOptions
     int size{48};
     WaterContent waterContent{WaterContent::Random};
     MonsterStrength monsterStrength{MonsterStrength::Random};
+    int threads{}; // Threads filling zones, 0 to use all hardware threads
 };
 
 class MapGenerator
@@ -55,7 +91,7 @@ public:
         , randomSeed{randomSeed}
         , debug{debug}
     {
-        randomGenerator.setSeed(static_cast<std::size_t>(randomSeed));
+        randomGenerator.setSeed(static_cast<std::uint64_t>(randomSeed));
     }
 
     CMidgardID createId(CMidgardID::Type type)
@@ -94,15 +130,36 @@ public:
 
     void addHeaderInfo();
     void initTiles();
+    void initMountains();
+    void initPickPools();
     void generateZones();
     void fillZones();
     void setupDiplomacy();
     void createDirectConnections();
+    // Groups zones into waves of zones that are far enough to be filled at the same time
+    void createZoneWaves();
+    // Switches all zones to random streams of specified phase
+    void startZonePhase(ZonePhase phase);
+    // Runs task of specified phase for each zone wave by wave,
+    // then commits objects created by zones
+    void runZoneTasks(ThreadPool& pool,
+                      ZonePhase phase,
+                      const std::function<void(TemplateZone&)>& task);
+    // Adds objects created by zones to the map in order of zone ids
+    void commitZoneObjects();
     void createObstacles();
 
     TemplateZoneId getZoneId(const Position& position) const;
     void setZoneId(const Position& position, TemplateZoneId zoneId);
-    void checkIsOnMap(const Position& position) const;
+
+    // Throws if position is outside the map.
+    // Hot paths should validate positions once and use tiles directly
+    void checkIsOnMap(const Position& position) const
+    {
+        if (!map->isInTheMap(position)) {
+            reportNotOnMap(position);
+        }
+    }
 
     bool isBlocked(const Position& position) const;
     bool shouldBeBlocked(const Position& position) const;
@@ -114,15 +171,32 @@ public:
     void setOccupied(const Position& position, TileType value);
     void setRoad(const Position& position, bool value);
 
-    void foreachNeighbor(const Position& position, std::function<void(Position&)> f);
-    void foreachDirectNeighbor(const Position& position, std::function<void(Position&)> f);
-    void foreachDiagonalNeighbor(const Position& position, std::function<void(Position&)> f);
+    // Calls f for each neighbor tile position that is on the map.
+    // If f returns bool, iteration stops as soon as it returns true.
+    // Returns true if iteration was stopped early
+    template <typename F>
+    bool foreachNeighbor(const Position& position, F&& f) const
+    {
+        return visitNeighbors(position, Position::getDirections(), f);
+    }
+
+    template <typename F>
+    bool foreachDirectNeighbor(const Position& position, F&& f) const
+    {
+        return visitNeighbors(position, Position::getDirectDirections(), f);
+    }
+
+    template <typename F>
+    bool foreachDiagonalNeighbor(const Position& position, F&& f) const
+    {
+        return visitNeighbors(position, Position::getDiagonalDirections(), f);
+    }
 
     float getNearestObjectDistance(const Position& position) const;
     void setNearestObjectDistance(const Position& position, float value);
 
     void createRoads();
-    void createRoadObjects(const std::set<Position>& roads);
+    void createRoadObjects(const std::vector<std::uint8_t>& roads);
 
     // Returns global lord id for specified race
     CMidgardID getLordId(RaceType race) const
@@ -156,15 +230,16 @@ public:
     std::size_t getZoneCount(RaceType race);
     std::size_t getTotalZoneCount() const;
 
-    const TileInfo& getTile(const Position& position) const;
-    TileInfo& getTile(const Position& position);
+    // Returns copy of tile state
+    TileInfo getTile(const Position& position) const;
 
     // Creates png image with specified filename where each pixel represents TileInfo
     void debugTiles(const char* fileName) const;
 
+    // Returns index of tile in tiles grid
     std::size_t posToIndex(const Position& position) const
     {
-        return position.x + mapGenOptions.size * position.y;
+        return tiles.toIndex(position);
     }
 
     bool isDebugMode() const
@@ -172,9 +247,30 @@ public:
         return debug;
     }
 
-    std::vector<TileInfo> tiles;
-    std::vector<TemplateZoneId> zoneColoring;
+    // Returns known mountains grouped by size, bigger mountains first
+    const MountainsBySize& getMountainsBySize() const
+    {
+        return mountainsBySize;
+    }
+
+    const PickPools& getPickPools() const
+    {
+        return pickPools;
+    }
+
+    // Returns compositions of stacks with units of specified subraces,
+    // empty set allows any subrace. Tables are built once for each value bucket and subrace set
+    const StackCompositions& getStackCompositions(const std::set<SubRaceType>& subraces,
+                                                  int maxValue);
+
+    TileGrid tiles;
     ZonesMap zones;
+    std::vector<std::vector<TemplateZone*>> zoneWaves;
+    MountainsBySize mountainsBySize;
+    PickPools pickPools;
+    // Stack compositions by value bucket and subrace set
+    std::map<std::pair<int, std::set<SubRaceType>>, StackCompositionsEntry> stackCompositions;
+    std::mutex stackCompositionsMutex; // Guards stackCompositions map, but not its tables
     std::map<RaceType, std::size_t> zonesPerRace;
     std::map<RaceType, PlayerSubraceIdPair> raceToPlayers;
     MapPtr map;
@@ -184,7 +280,34 @@ public:
     CMidgardID neutralPlayerId;
     CMidgardID neutralSubraceId;
     std::size_t zonesTotal{}; // Zones with capital town only
+    std::mutex zonesMutex;    // Guards state shared by zones filled at the same time
     bool debug{};
+
+private:
+    [[noreturn]] void reportNotOnMap(const Position& position) const;
+
+    template <std::size_t N, typename F>
+    bool visitNeighbors(const Position& position,
+                        const std::array<Position, N>& directions,
+                        F& f) const
+    {
+        for (const auto& direction : directions) {
+            Position p{position + direction};
+            if (!map->isInTheMap(p)) {
+                continue;
+            }
+
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, Position&>, bool>) {
+                if (f(p)) {
+                    return true;
+                }
+            } else {
+                f(p);
+            }
+        }
+
+        return false;
+    }
 };
 
 } // namespace rsg
@@ -23,31 +23,65 @@
 #include <algorithm>
 #include <functional>
 #include <initializer_list>
+#include <iterator>
 #include <vector>
 
 namespace rsg {
 
+template <typename T>
+using PickFilterList = std::initializer_list<std::function<bool(const T*)>>;
+
+// Returns true if element should be removed from pick by any of filters
+template <typename T>
+bool isFilteredOut(const T* element, const PickFilterList<T>& filters)
+{
+    return std::any_of(filters.begin(), filters.end(),
+                       [element](const auto& filter) { return filter(element); });
+}
+
+// Returns elements of pool that satisfy specified filters keeping their order.
+// Filters that are the same for every pick are applied once this way,
+// so picks check only filters that depend on pick arguments
+template <typename T>
+std::vector<T*> filterPool(const std::vector<T*>& pool, const PickFilterList<T>& filters)
+{
+    std::vector<T*> filteredPool;
+    std::copy_if(pool.begin(), pool.end(), std::back_inserter(filteredPool),
+                 [&filters](const T* element) { return !isFilteredOut(element, filters); });
+
+    return filteredPool;
+}
+
 // Picks random element from pool that satisfies specified filters.
 // Returns nullptr if there are no suitable elements.
+// Suitable elements are counted first, then chosen one is found by second pass,
+// so pool is not copied
 template <typename T>
-T* pick(const std::vector<T*>& pool,
-        RandomGenerator& random,
-        const std::initializer_list<std::function<bool(const T*)>>& filters)
+T* pick(const std::vector<T*>& pool, RandomGenerator& random, const PickFilterList<T>& filters)
 {
-    std::vector<T*> filteredPool{pool};
-
-    for (auto& filter : filters) {
-        filteredPool.erase(std::remove_if(filteredPool.begin(), filteredPool.end(), filter),
-                           filteredPool.end());
-    }
+    const auto total{static_cast<std::size_t>(
+        std::count_if(pool.begin(), pool.end(),
+                      [&filters](const T* element) { return !isFilteredOut(element, filters); }))};
 
-    if (filteredPool.empty()) {
+    if (!total) {
         // Filters are too tight, nothing to pick
         return nullptr;
     }
 
-    const std::size_t index{random.nextInteger(std::size_t{0}, filteredPool.size() - 1)};
-    return filteredPool[index];
+    std::size_t index{random.nextInteger(std::size_t{0}, total - 1)};
+    for (T* element : pool) {
+        if (isFilteredOut(element, filters)) {
+            continue;
+        }
+
+        if (!index) {
+            return element;
+        }
+
+        --index;
+    }
+
+    return nullptr;
 }
 
 } // namespace rsg
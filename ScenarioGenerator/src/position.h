@@ -140,6 +140,38 @@ struct Position
         return directions;
     }
 
+    // Returns array of directions to direct neighbor tile positions.
+    // Directions are set clockwise, starting from north.
+    // This is important for road indices!
+    static const std::array<Position, 4>& getDirectDirections()
+    {
+        // clang-format off
+        static const std::array<Position, 4> directions{{
+            Position{ 0, -1},
+            Position{ 1,  0},
+            Position{ 0,  1},
+            Position{-1,  0}
+        }};
+        // clang-format on
+
+        return directions;
+    }
+
+    // Returns array of directions to diagonal neighbor tile positions
+    static const std::array<Position, 4>& getDiagonalDirections()
+    {
+        // clang-format off
+        static const std::array<Position, 4> directions{{
+            Position{-1, -1},
+            Position{ 1, -1},
+            Position{-1,  1},
+            Position{ 1,  1}
+        }};
+        // clang-format on
+
+        return directions;
+    }
+
     friend std::ostream& operator<<(std::ostream& os, const Position& p)
     {
         return os << '(' << p.x << ", " << p.y << ')';
@@ -0,0 +1,147 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <cstdint>
+#include <limits>
+
+namespace rsg {
+
+// Random engines that can be used by RandomGenerator instead of std::mt19937.
+// Both are much faster than mt19937 and have small state that is cheap to copy and seed.
+
+// PCG32 (XSH RR variant) by Melissa O'Neill, https://www.pcg-random.org
+class Pcg32
+{
+public:
+    using result_type = std::uint32_t;
+
+    Pcg32()
+    {
+        seed(0u);
+    }
+
+    explicit Pcg32(std::uint64_t value)
+    {
+        seed(value);
+    }
+
+    static constexpr result_type min()
+    {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    void seed(std::uint64_t value)
+    {
+        state = 0u;
+        (*this)();
+        state += value;
+        (*this)();
+    }
+
+    result_type operator()()
+    {
+        const std::uint64_t oldState{state};
+        state = oldState * 6364136223846793005ull + increment;
+
+        const auto xorShifted{static_cast<std::uint32_t>(((oldState >> 18u) ^ oldState) >> 27u)};
+        const auto rotation{static_cast<std::uint32_t>(oldState >> 59u)};
+
+        return (xorShifted >> rotation) | (xorShifted << ((32u - rotation) & 31u));
+    }
+
+private:
+    static constexpr std::uint64_t increment{1442695040888963407ull};
+
+    std::uint64_t state{};
+};
+
+// xoshiro256** by David Blackman and Sebastiano Vigna, https://prng.di.unimi.it
+class Xoshiro256StarStar
+{
+public:
+    using result_type = std::uint64_t;
+
+    Xoshiro256StarStar()
+    {
+        seed(0u);
+    }
+
+    explicit Xoshiro256StarStar(std::uint64_t value)
+    {
+        seed(value);
+    }
+
+    static constexpr result_type min()
+    {
+        return std::numeric_limits<result_type>::min();
+    }
+
+    static constexpr result_type max()
+    {
+        return std::numeric_limits<result_type>::max();
+    }
+
+    // State is filled using SplitMix64 as recommended by the authors,
+    // so it is never all zeroes
+    void seed(std::uint64_t value)
+    {
+        for (auto& word : state) {
+            value += 0x9e3779b97f4a7c15ull;
+
+            std::uint64_t z{value};
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+            word = z ^ (z >> 31);
+        }
+    }
+
+    result_type operator()()
+    {
+        const std::uint64_t result{rotateLeft(state[1] * 5u, 7) * 9u};
+        const std::uint64_t t{state[1] << 17};
+
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+
+        state[2] ^= t;
+        state[3] = rotateLeft(state[3], 45);
+
+        return result;
+    }
+
+private:
+    static std::uint64_t rotateLeft(std::uint64_t value, int shift)
+    {
+        return (value << shift) | (value >> (64 - shift));
+    }
+
+    std::uint64_t state[4]{};
+};
+
+} // namespace rsg
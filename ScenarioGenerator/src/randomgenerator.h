@@ -19,14 +19,19 @@
 
 #pragma once
 
+#include "randomengines.h"
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
 #include <ctime>
 #include <functional>
+#include <iterator>
+#include <limits>
 #include <numeric>
 #include <random>
 #include <thread>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace rsg {
@@ -57,62 +62,83 @@ struct RandomValue
 class RandomGenerator
 {
 public:
-    using RandI64 = std::function<std::int64_t()>;
-    using Rand = std::function<double()>;
-    using Engine = std::mt19937;
+    // Engine is chosen at compile time, std::mt19937 and Pcg32 can be used as well.
+    // All of them are specified exactly and produce the same values on every platform.
+    // Different engines produce different scenarios from the same seed
+    using Engine = Xoshiro256StarStar;
 
     RandomGenerator()
     {
         resetSeed();
     }
 
-    // Returns random integer value according to its range
-    template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
-    T pickValue(const RandomValue<T>& value)
+    explicit RandomGenerator(std::uint64_t seed)
     {
-        return static_cast<T>(getInt64Range(value.min, value.max)());
+        setSeed(seed);
     }
 
-    // Returns floating point value according to its range
-    template <typename T, std::enable_if_t<std::is_floating_point<T>::value, bool> = true>
-    T pickValue(const RandomValue<T>& value)
+    // Returns generator of independent stream specified by key.
+    // Stream depends only on seed of this generator and the key, not on values drawn before,
+    // so streams can be forked and used in any order
+    RandomGenerator fork(std::uint64_t streamKey) const
     {
-        return static_cast<T>(getDoubleRange(value.min, value.max)());
+        return RandomGenerator{mixSeed(seed, streamKey)};
     }
 
-    // Returns functor that produces random integer values in [min : max] range
-    RandI64 getInt64Range(std::int64_t min, std::int64_t max)
+    // Returns random integer value according to its range
+    template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
+    T pickValue(const RandomValue<T>& value)
     {
-        using Distribution = std::uniform_int_distribution<std::int64_t>;
-
-        return std::bind(Distribution(min, max), std::ref(engine));
+        return nextInteger(value.min, value.max);
     }
 
-    // Returns functor that produces random floating point values in [min : max] range
-    Rand getDoubleRange(double min, double max)
+    // Returns floating point value according to its range
+    template <typename T, std::enable_if_t<std::is_floating_point<T>::value, bool> = true>
+    T pickValue(const RandomValue<T>& value)
     {
-        using Distribution = std::uniform_real_distribution<double>;
-
-        return std::bind(Distribution(min, max), std::ref(engine));
+        return static_cast<T>(nextDouble(value.min, value.max));
     }
 
+    // Returns random integer value in [min : max] range
     template <typename T, std::enable_if_t<std::is_integral<T>::value, bool> = true>
     T nextInteger(T min, T max)
     {
-        return static_cast<T>(getInt64Range(min, max)());
+        assert(min <= max);
+
+        // Computed in unsigned 64-bit arithmetic, so full range of any integer type fits
+        const auto start{static_cast<std::uint64_t>(min)};
+        const auto range{static_cast<std::uint64_t>(max) - start};
+        if (range == std::numeric_limits<std::uint64_t>::max()) {
+            return static_cast<T>(start + nextBits());
+        }
+
+        return static_cast<T>(start + nextBelow(range + 1));
     }
 
-    // Returns random floating point value in [min : max] range
+    // Returns random floating point value in [min : max) range
     double nextDouble(double min, double max)
     {
-        return getDoubleRange(min, max)();
+        // 53 random bits fill mantissa exactly, so value in [0 : 1) is the same everywhere
+        const double unit{static_cast<double>(nextBits() >> 11) * 0x1.0p-53};
+        return min + unit * (max - min);
     }
 
     // Returns true with chance specified by percent
     bool chance(int percent)
     {
         percent = std::clamp(percent, 0, 100);
-        return nextDouble(0, 99) < percent;
+        return nextBelow(99) < static_cast<std::uint64_t>(percent);
+    }
+
+    // Assigns results of chance() with the same percent to each element in [first : last) range
+    template <typename Iterator>
+    void fillChances(Iterator first, Iterator last, int percent)
+    {
+        percent = std::clamp(percent, 0, 100);
+
+        for (; first != last; ++first) {
+            *first = nextBelow(99) < static_cast<std::uint64_t>(percent);
+        }
     }
 
     void resetSeed()
@@ -123,51 +149,126 @@ public:
         setSeed(threadIdHash * (std::size_t)std::time(nullptr));
     }
 
-    void setSeed(std::size_t seed)
+    // Seed is 64-bit on every platform, so forked streams do not depend on size of std::size_t
+    void setSeed(std::uint64_t value)
     {
-        engine.seed(seed);
+        seed = value;
+        engine.seed(value);
     }
 
-    Engine& getEngine()
+private:
+    static_assert(Engine::min() == 0u
+                      && (Engine::max() == std::numeric_limits<std::uint64_t>::max()
+                          || Engine::max() == std::numeric_limits<std::uint32_t>::max()),
+                  "Engine must produce 32 or 64 random bits");
+
+    // Returns 64 random bits, engines with 32-bit output are called twice
+    std::uint64_t nextBits()
     {
-        return engine;
+        if constexpr (Engine::max() == std::numeric_limits<std::uint64_t>::max()) {
+            return engine();
+        } else {
+            const std::uint64_t high{engine()};
+            return (high << 32) | engine();
+        }
+    }
+
+    // Returns random value in [0 : bound) range using rejection sampling.
+    // Values below threshold are rejected, otherwise smaller results are more likely
+    std::uint64_t nextBelow(std::uint64_t bound)
+    {
+        const std::uint64_t threshold{(std::uint64_t{0} - bound) % bound};
+
+        while (true) {
+            const auto bits{nextBits()};
+            if (bits >= threshold) {
+                return bits % bound;
+            }
+        }
+    }
+
+    // SplitMix64 finalizer over seed and stream key
+    static std::uint64_t mixSeed(std::uint64_t seed, std::uint64_t streamKey)
+    {
+        std::uint64_t value{seed + (streamKey + 1) * 0x9e3779b97f4a7c15ull};
+        value = (value ^ (value >> 30)) * 0xbf58476d1ce4e5b9ull;
+        value = (value ^ (value >> 27)) * 0x94d049bb133111ebull;
+
+        return value ^ (value >> 31);
     }
 
-private:
     Engine engine;
+    std::uint64_t seed{};
 };
 
-// Reorders elements in container randomly.
+// Distributions, shuffle and sample are implemented here instead of using standard ones.
+// Standard library implementations differ, so the same seed would give different scenarios
+// on different platforms
+
+// Reorders elements in container randomly using Fisher-Yates shuffle.
 template <typename T>
 static inline void randomShuffle(std::vector<T>& container, RandomGenerator& rand)
 {
-    std::shuffle(container.begin(), container.end(), rand.getEngine());
+    for (std::size_t i = container.size(); i > 1; --i) {
+        const auto j{rand.nextInteger(std::size_t{0}, i - 1)};
+        std::swap(container[i - 1], container[j]);
+    }
+}
+
+// Copies n randomly chosen elements of [first : last) range to result keeping their order.
+// Uses selection sampling (Knuth's algorithm S)
+template <typename InputIterator, typename OutputIterator>
+static inline OutputIterator randomSample(InputIterator first,
+                                          InputIterator last,
+                                          OutputIterator result,
+                                          std::size_t n,
+                                          RandomGenerator& rand)
+{
+    auto remaining{static_cast<std::size_t>(std::distance(first, last))};
+
+    for (; n > 0 && first != last; ++first, --remaining) {
+        if (rand.nextInteger(std::size_t{0}, remaining - 1) < n) {
+            *result++ = *first;
+            --n;
+        }
+    }
+
+    return result;
 }
 
 // Returns a randomly chosen vector of n positive integers summing exactly to total
 // From:
 // https://stackoverflow.com/questions/3589214/generate-random-numbers-summing-to-a-predefined-value
+// Dividers are a uniformly chosen subset of [1 : total] picked with Floyd's algorithm,
+// so only n - 1 values are drawn and no buffer of total elements is needed
 static inline std::vector<std::size_t> constrainedSum(std::size_t n,
                                                       std::size_t total,
                                                       RandomGenerator& rand)
 {
-    std::vector<std::size_t> tmp(total);
-    std::iota(tmp.begin(), tmp.end(), 1);
+    // Wraps around for zero n and picks every value, same as sampling n - 1 of total did
+    const std::size_t dividersTotal{std::min(n - 1, total)};
 
-    std::vector<std::size_t> dividers;
-    std::sample(tmp.begin(), tmp.end(), std::back_inserter(dividers), n - 1, rand.getEngine());
-
-    std::sort(dividers.begin(), dividers.end());
-
-    std::vector<std::size_t> a = dividers;
-    a.push_back(total);
+    std::vector<std::size_t> result;
+    result.reserve(dividersTotal + 1);
+
+    // Dividers are kept sorted, so membership test is a binary search
+    for (std::size_t j = total - dividersTotal + 1; j <= total; ++j) {
+        const auto value{rand.nextInteger(std::size_t{1}, j)};
+
+        auto it{std::lower_bound(result.begin(), result.end(), value)};
+        if (it != result.end() && *it == value) {
+            // Value was picked already, j is larger than any picked value
+            result.push_back(j);
+        } else {
+            result.insert(it, value);
+        }
+    }
 
-    std::vector<std::size_t> b = dividers;
-    b.insert(b.begin(), 0);
+    result.push_back(total);
 
-    std::vector<std::size_t> result;
-    for (std::size_t i = 0; i < a.size(); ++i) {
-        result.push_back(a[i] - b[i]);
+    // Turn dividers into differences between neighbors in place
+    for (std::size_t i = result.size() - 1; i > 0; --i) {
+        result[i] -= result[i - 1];
     }
 
     return result;
@@ -158,6 +158,12 @@ public:
         return value <= other.value;
     }
 
+    /** Returns raw 32 bit value. */
+    constexpr std::uint32_t getValue() const
+    {
+        return value;
+    }
+
     Category getCategory() const;
 
     std::uint32_t getCategoryIndex() const;
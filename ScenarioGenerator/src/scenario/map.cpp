@@ -35,8 +35,11 @@
 #include "stackdestroyed.h"
 #include "subrace.h"
 #include "turnsummary.h"
+#include <algorithm>
 #include <cassert>
+#include <limits>
 #include <sstream>
+#include <stdexcept>
 
 namespace rsg {
 
@@ -118,8 +121,20 @@ void Map::serialize(const std::filesystem::path& scenarioFilePath)
     serializer.serialize(idString.data(), static_cast<std::uint32_t>(objects.size()));
     serializer.leaveRecord();
 
-    // Write objects
+    // Write objects in order of their ids,
+    // iteration order of unordered map differs between standard library implementations
+    std::vector<const ScenarioObject*> sortedObjects;
+    sortedObjects.reserve(objects.size());
     for (const auto& [id, object] : objects) {
+        sortedObjects.push_back(object.get());
+    }
+
+    std::sort(sortedObjects.begin(), sortedObjects.end(),
+              [](const ScenarioObject* a, const ScenarioObject* b) {
+                  return a->getId() < b->getId();
+              });
+
+    for (const ScenarioObject* object : sortedObjects) {
         serializer.enterRecord();
         serializer.serialize("WHAT", object->rawName());
         serializer.serialize("OBJ_ID", object->getId());
@@ -142,6 +157,8 @@ void Map::calculateGuardingCreaturePositions()
 
 CMidgardID Map::createId(CMidgardID::Type type)
 {
+    std::lock_guard<std::mutex> lock(idsMutex);
+
     auto freeTypeIndex{freeIdTypeIndices[static_cast<std::size_t>(type)]++};
     assert(freeTypeIndex >= 0 && freeTypeIndex <= std::numeric_limits<std::uint16_t>::max());
 
@@ -150,6 +167,61 @@ CMidgardID Map::createId(CMidgardID::Type type)
                       static_cast<std::uint16_t>(freeTypeIndex)};
 }
 
+IdBlock Map::reserveIds(int count)
+{
+    constexpr int maxTypeIndex{std::numeric_limits<std::uint16_t>::max()};
+
+    std::lock_guard<std::mutex> lock(idsMutex);
+
+    IdBlock block;
+    block.scenarioId = scenarioId;
+    block.map = this;
+    block.count = count;
+
+    for (std::size_t i = 0; i < freeIdTypeIndices.size(); ++i) {
+        block.freeTypeIndices[i] = freeIdTypeIndices[i];
+        freeIdTypeIndices[i] = std::min(freeIdTypeIndices[i] + count, maxTypeIndex + 1);
+        block.endTypeIndices[i] = freeIdTypeIndices[i];
+    }
+
+    return block;
+}
+
+bool Map::reserveMoreIds(IdBlock& block, CMidgardID::Type type)
+{
+    constexpr int maxTypeIndex{std::numeric_limits<std::uint16_t>::max()};
+
+    std::lock_guard<std::mutex> lock(idsMutex);
+
+    const auto typeIndex{static_cast<std::size_t>(type)};
+    auto& freeTypeIndex{freeIdTypeIndices[typeIndex]};
+    if (freeTypeIndex > maxTypeIndex) {
+        return false;
+    }
+
+    block.freeTypeIndices[typeIndex] = freeTypeIndex;
+    freeTypeIndex = std::min(freeTypeIndex + block.count, maxTypeIndex + 1);
+    block.endTypeIndices[typeIndex] = freeTypeIndex;
+    return true;
+}
+
+CMidgardID IdBlock::createId(CMidgardID::Type type)
+{
+    const auto typeIndex{static_cast<std::size_t>(type)};
+    if (freeTypeIndices[typeIndex] >= endTypeIndices[typeIndex]
+        && (!map || !map->reserveMoreIds(*this, type))) {
+        std::stringstream stream;
+        stream << "Identifiers of type " << typeIndex << " are exhausted";
+        throw std::runtime_error(stream.str());
+    }
+
+    const auto freeTypeIndex{freeTypeIndices[typeIndex]++};
+
+    return CMidgardID{CMidgardID::Category::Scenario,
+                      static_cast<std::uint8_t>(scenarioId.getCategoryIndex()), type,
+                      static_cast<std::uint16_t>(freeTypeIndex)};
+}
+
 bool Map::insertObject(ScenarioObjectPtr&& object)
 {
     const auto& objectId{object->getId()};
@@ -172,13 +244,12 @@ void Map::insertMapElement(const MapElement& mapElement, const CMidgardID& mapEl
 
 void Map::addBlockVisTiles(const MapElement& mapElement, const CMidgardID& mapElementId)
 {
-    auto blocking{mapElement.getBlockedPositions()};
+    const auto& elementPosition{mapElement.getPosition()};
     auto entrance{mapElement.getEntrance()};
 
-    blocking.insert(entrance);
-
-    for (const auto& position : blocking) {
-        auto& tile{getTile(position)};
+    // Map element blocks all of its tiles, including entrance
+    for (const auto& offset : mapElement.getBlockedOffsets()) {
+        auto& tile{getTile(elementPosition + offset)};
         tile.blocked = true;
         tile.blockingObjects.push_back(mapElementId);
     }
@@ -218,11 +289,22 @@ ScenarioObject* Map::find(const CMidgardID& objectId)
 
 void Map::visit(CMidgardID::Type objectType, std::function<void(const ScenarioObject*)> f) const
 {
+    // Objects are visited in order of their ids to make results the same on all platforms
+    std::vector<const ScenarioObject*> typeObjects;
     for (const auto& [id, object] : objects) {
         if (id.getType() == objectType) {
-            f(object.get());
+            typeObjects.push_back(object.get());
         }
     }
+
+    std::sort(typeObjects.begin(), typeObjects.end(),
+              [](const ScenarioObject* a, const ScenarioObject* b) {
+                  return a->getId() < b->getId();
+              });
+
+    for (const ScenarioObject* object : typeObjects) {
+        f(object);
+    }
 }
 
 const Tile& Map::getTile(const Position& position) const
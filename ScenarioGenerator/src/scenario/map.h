@@ -28,6 +28,7 @@
 #include <filesystem>
 #include <functional>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -79,6 +80,29 @@ struct MapHeader
     MapFormat version{MapFormat::Rote};
 };
 
+class Map;
+
+// Identifiers reserved by Map::reserveIds().
+// Reserved identifiers can be created without access to the map.
+// When identifiers of some type run out, block reserves more of them from the map
+class IdBlock
+{
+public:
+    // Throws if identifiers of specified type are exhausted in the whole map
+    CMidgardID createId(CMidgardID::Type type);
+
+private:
+    friend class Map;
+
+    using TypeIndices = std::array<int, (size_t)CMidgardID::Type::Invalid>;
+
+    TypeIndices freeTypeIndices{};
+    TypeIndices endTypeIndices{};
+    CMidgardID scenarioId;
+    Map* map{};
+    int count{};
+};
+
 // Scenario map, holds scenario objects
 class Map : public MapHeader
 {
@@ -92,6 +116,11 @@ public:
     void calculateGuardingCreaturePositions();
 
     CMidgardID createId(CMidgardID::Type type);
+    // Reserves specified number of identifiers of each type
+    IdBlock reserveIds(int count);
+    // Reserves identifiers of specified type once more for block that used its own.
+    // Returns false if there are no free identifiers of the type
+    bool reserveMoreIds(IdBlock& block, CMidgardID::Type type);
 
     bool insertObject(ScenarioObjectPtr&& object);
     void insertMapElement(const MapElement& mapElement, const CMidgardID& mapElementId);
@@ -182,6 +211,7 @@ private:
     std::vector<Tile> tiles;
     std::vector<Position> guardingCreaturePositions;
     std::array<int, (size_t)CMidgardID::Type::Invalid> freeIdTypeIndices{};
+    std::mutex idsMutex; // Guards freeIdTypeIndices, zones can reserve ids at the same time
     CMidgardID scenarioId;
     Plan* plan{};
     Diplomacy* diplomacy{};
@@ -20,7 +20,11 @@
 #pragma once
 
 #include "position.h"
+#include <algorithm>
+#include <array>
+#include <map>
 #include <set>
+#include <vector>
 
 namespace rsg {
 
@@ -64,32 +68,24 @@ public:
         std::set<Position> blocked;
 
         const auto entrance{getEntrance()};
-        for (int x = 0; x < size.x; ++x) {
-            for (int y = 0; y < size.y; ++y) {
-                Position pos{position.x + x, position.y + y};
+        for (const auto& offset : getBlockedOffsets()) {
+            const Position pos{position + offset};
 
-                if (pos == entrance) {
-                    continue;
-                }
-
-                blocked.insert(pos);
+            if (pos == entrance) {
+                continue;
             }
+
+            blocked.insert(blocked.end(), pos);
         }
 
         return blocked;
     }
 
-    std::set<Position> getBlockedOffsets() const
+    // Returns offsets of all tiles covered by map element, including entrance.
+    // Offsets are sorted the same way as positions
+    const std::vector<Position>& getBlockedOffsets() const
     {
-        std::set<Position> offsets;
-
-        for (int x = 0; x < size.x; ++x) {
-            for (int y = 0; y < size.y; ++y) {
-                offsets.insert(Position{x, y});
-            }
-        }
-
-        return offsets;
+        return getFootprint(size);
     }
 
     Position getEntranceOffset() const
@@ -123,6 +119,54 @@ public:
 protected:
     Position position; // Top-left corner of the object
     Position size;     // Size of object in tiles
+
+private:
+    using Footprint = std::vector<Position>;
+
+    static Footprint createFootprint(const Position& size)
+    {
+        Footprint footprint;
+        footprint.reserve(static_cast<std::size_t>(std::max(0, size.x * size.y)));
+
+        for (int y = 0; y < size.y; ++y) {
+            for (int x = 0; x < size.x; ++x) {
+                footprint.push_back(Position{x, y});
+            }
+        }
+
+        return footprint;
+    }
+
+    // Returns cached offsets of tiles covered by map element of specified size
+    static const Footprint& getFootprint(const Position& size)
+    {
+        // Scenario objects, landmarks and mountains are not bigger than this
+        static constexpr int maxCachedSize{8};
+
+        static const auto footprints{[]() {
+            std::array<std::array<Footprint, maxCachedSize + 1>, maxCachedSize + 1> result;
+            for (int x = 0; x <= maxCachedSize; ++x) {
+                for (int y = 0; y <= maxCachedSize; ++y) {
+                    result[x][y] = createFootprint(Position{x, y});
+                }
+            }
+
+            return result;
+        }()};
+
+        if (size.x >= 0 && size.x <= maxCachedSize && size.y >= 0 && size.y <= maxCachedSize) {
+            return footprints[size.x][size.y];
+        }
+
+        thread_local std::map<std::pair<int, int>, Footprint> bigFootprints;
+
+        auto& footprint{bigFootprints[{size.x, size.y}]};
+        if (footprint.empty()) {
+            footprint = createFootprint(size);
+        }
+
+        return footprint;
+    }
 };
 
 } // namespace rsg
@@ -20,7 +20,7 @@
 #pragma once
 
 #include "site.h"
-#include <unordered_map>
+#include <map>
 #include <utility>
 
 namespace rsg {
@@ -44,7 +44,8 @@ public:
 private:
     void serializeSite(Serializer& serializer, const Map& scenario) const override;
 
-    std::unordered_map<CMidgardID, std::uint32_t /* count */, CMidgardIDHash> items;
+    // Ordered by id, so items are written the same way on all platforms
+    std::map<CMidgardID, std::uint32_t /* count */> items;
 };
 
 } // namespace rsg
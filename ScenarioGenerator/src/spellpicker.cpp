@@ -21,27 +21,15 @@
 #include "containers.h"
 #include "gameinfo.h"
 #include "generatorsettings.h"
-#include "randomgenerator.h"
+#include "picker.h"
 
 namespace rsg {
 
-static SpellInfo* pickSpell(const SpellInfoArray& spellsPool,
-                            RandomGenerator& random,
-                            const SpellFilterList& filters)
+SpellInfo* pickSpell(const std::vector<SpellInfo*>& spellPool,
+                     RandomGenerator& random,
+                     const SpellFilterList& filters)
 {
-    SpellInfoArray pool{spellsPool};
-
-    for (auto& filter : filters) {
-        pool.erase(std::remove_if(pool.begin(), pool.end(), filter), pool.end());
-    }
-
-    if (pool.empty()) {
-        // Filters are too tight, nothing to pick
-        return nullptr;
-    }
-
-    const auto index{static_cast<std::size_t>(random.getInt64Range(0, pool.size() - 1)())};
-    return pool[index];
+    return pick(spellPool, random, filters);
 }
 
 SpellInfo* pickSpell(RandomGenerator& random, const SpellFilterList& filters)
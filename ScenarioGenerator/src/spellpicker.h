@@ -33,6 +33,10 @@ class RandomGenerator;
 using SpellFilterFunc = std::function<bool(const SpellInfo*)>;
 using SpellFilterList = std::initializer_list<SpellFilterFunc>;
 
+// Picks random spell from specified pool
+SpellInfo* pickSpell(const std::vector<SpellInfo*>& spellPool,
+                     RandomGenerator& random,
+                     const SpellFilterList& filters);
 // Picks any random spell after applying filters
 SpellInfo* pickSpell(RandomGenerator& random, const SpellFilterList& filters);
 // Picks random spell of specific type
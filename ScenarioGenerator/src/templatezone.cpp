@@ -22,6 +22,7 @@
 #include "capital.h"
 #include "containers.h"
 #include "crystal.h"
+#include "distancetransform.h"
 #include "exceptions.h"
 #include "generatorsettings.h"
 #include "item.h"
@@ -42,9 +43,12 @@
 #include "unit.h"
 #include "unitpicker.h"
 #include "village.h"
+#include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <iterator>
+#include <limits>
+#include <mutex>
 #include <sstream>
 
 namespace rsg {
@@ -137,6 +141,11 @@ static void checkObjectsAccess(const MapGenerator& mapGenerator, const Map& map)
     });
 }
 
+TemplateZone::TemplateZone(MapGenerator* mapGenerator)
+    : mapGenerator{mapGenerator}
+    , freePathField{mapGenerator->tiles}
+{ }
+
 void TemplateZone::setCenter(const VPosition& value)
 {
     // Wrap zone around (0, 1) square.
@@ -166,6 +175,74 @@ void TemplateZone::clearEntrance(const Fortification& fort)
     mapGenerator->foreachNeighbor(fort.getEntrance() + Position(1, 1), clearPosition);
 }
 
+void TemplateZone::prepare(const RandomGenerator& zoneStream, IdBlock&& ids)
+{
+    randomStream = zoneStream;
+    reservedIds = std::move(ids);
+
+    const auto totalTiles{mapGenerator->tiles.getTotalTiles()};
+    pathfinder.resize(totalTiles);
+    freePathField.reset(id);
+}
+
+void TemplateZone::commitObjects()
+{
+    auto& map{*mapGenerator->map};
+
+    for (auto& object : newObjects) {
+        map.insertObject(std::move(object));
+    }
+
+    for (const auto& [mapElement, mapElementId] : newMapElements) {
+        map.insertMapElement(*mapElement, mapElementId);
+    }
+
+    for (const auto& mountain : newMountains) {
+        map.addMountain(mountain.position, mountain.size, mountain.image);
+    }
+
+    for (const auto& talismanId : newTalismans) {
+        map.addTalismanCharge(talismanId);
+    }
+
+    newObjects.clear();
+    newMapElements.clear();
+    newMountains.clear();
+    newTalismans.clear();
+}
+
+void TemplateZone::insertObject(ScenarioObjectPtr&& object)
+{
+    newObjects.push_back(std::move(object));
+}
+
+void TemplateZone::insertObject(std::unique_ptr<Item>&& item)
+{
+    // Add talisman charges each time we insert talisman item on the map
+    if (isTalisman(item->getItemType())) {
+        newTalismans.push_back(item->getId());
+    }
+
+    newObjects.push_back(std::move(item));
+}
+
+void TemplateZone::insertMapElement(const MapElement& mapElement, const CMidgardID& mapElementId)
+{
+    newMapElements.emplace_back(&mapElement, mapElementId);
+}
+
+ScenarioObject* TemplateZone::findObject(const CMidgardID& objectId)
+{
+    // Objects are usually needed right after they were created
+    for (auto it = newObjects.rbegin(); it != newObjects.rend(); ++it) {
+        if ((*it)->getId() == objectId) {
+            return it->get();
+        }
+    }
+
+    return mapGenerator->map->find(objectId);
+}
+
 void TemplateZone::initTowns()
 {
     if (type == TemplateZoneType::Water) {
@@ -200,6 +277,13 @@ void TemplateZone::initFreeTiles()
                      return this->mapGenerator->isPossible(position);
                  });
 
+    const auto& tiles{mapGenerator->tiles};
+
+    possibleTilesByDistance.clear();
+    for (const auto& tile : possibleTiles) {
+        possibleTilesByDistance.insert({tiles.getNearestObjectDistance(tiles.toIndex(tile)), tile});
+    }
+
     // Zone must have at least one free tile where other paths go - for instance in the center
     if (freePaths.empty()) {
         addFreePath(getPosition());
@@ -212,13 +296,12 @@ void TemplateZone::createBorder()
     std::size_t openBorders{};
     std::size_t closedBorders{};
 
-    for (auto& tile : tileInfo) {
-        bool border{};
+    const auto& grid{mapGenerator->tiles};
+    auto otherZone = [this, &grid](std::size_t index) { return grid.getZoneId(index) != id; };
 
-        mapGenerator->foreachNeighbor(tile, [this, &border, &borderTiles, &openBorders,
-                                             &closedBorders](const Position& position) {
-            border = border || mapGenerator->getZoneId(position) != id;
-        });
+    for (auto& tile : tileInfo) {
+        // Tile is at the border if any of its neighbors belongs to another zone
+        const bool border{grid.foreachNeighbor(grid.toIndex(tile), otherZone)};
 
         if (border) {
             ++borderTiles;
@@ -243,7 +326,7 @@ void TemplateZone::createBorder()
                     break;
 
                 case ZoneBorderType::SemiOpen: {
-                    const bool gap{mapGenerator->randomGenerator.chance(gapChance)};
+                    const bool gap{randomGenerator.chance(gapChance)};
 
                     mapGenerator->setOccupied(tile, gap ? TileType::Free : TileType::Blocked);
                     if (gap) {
@@ -290,6 +373,9 @@ void TemplateZone::fill()
     placeStacks();
     placeBags();
 
+    // Free path field is not needed after zone is filled, stop recording changed tiles
+    freePathField.reset(id);
+
     if (mapGenerator->isDebugMode()) {
         std::cout << "Zone " << id << " filled successfully\n";
     }
@@ -304,8 +390,7 @@ void TemplateZone::createObstacles()
 
     // Place decorations first
     for (const auto& decoration : decorations) {
-        decoration->decorate(*this, *mapGenerator, *mapGenerator->map,
-                             mapGenerator->randomGenerator);
+        decoration->decorate(*this, *mapGenerator, *mapGenerator->map, randomGenerator);
     }
 
     decorations.clear();
@@ -317,48 +402,89 @@ void TemplateZone::createObstacles()
         std::cout << "Place mountains\n";
     }
 
-    using MountainsVector = std::vector<GeneratorSettings::Mountain>;
-    using MountainPair = std::pair<int /* mountain size */, MountainsVector>;
+    const auto& possibleObstacles{mapGenerator->getMountainsBySize()};
+    // Biggest mountains are first
+    const int maxSize{possibleObstacles.empty() ? 0 : possibleObstacles.front().first};
+
+    const auto& grid{mapGenerator->tiles};
+    const auto mapSize{grid.getSize()};
+    const auto stride{mapSize + 1};
+
+    // Sizes of the largest squares of blocked tiles with top-left corners at each tile.
+    // Sizes are limited by the biggest mountain, extra row and column of zeroes
+    // stand for tiles outside the map
+    std::vector<int> squareSizes(static_cast<std::size_t>(stride) * stride, 0);
 
-    std::map<int /* mountain size */, MountainsVector> obstaclesBySize;
-    std::vector<MountainPair> possibleObstacles;
+    // Tiles that mountains started at zone tiles can cover.
+    // Other tiles may belong to zones filled at the same time and are never read,
+    // they are treated as not blocked. Squares at zone tiles do not change because of that:
+    // square of the biggest mountain started at zone tile covers only marked tiles
+    std::vector<std::uint8_t> reachable(static_cast<std::size_t>(stride) * stride, 0);
+    for (const auto& tile : tileInfo) {
+        const auto right{std::min(mapSize - 1, tile.x + maxSize - 1)};
+        const auto bottom{std::min(mapSize - 1, tile.y + maxSize - 1)};
 
-    const auto& knownMountains = getGeneratorSettings().mountains;
-    for (const auto& mountain : knownMountains) {
-        obstaclesBySize[mountain.size].push_back(mountain);
+        for (int y = tile.y; y <= bottom; ++y) {
+            for (int x = tile.x; x <= right; ++x) {
+                reachable[x + y * stride] = 1;
+            }
+        }
     }
 
-    for (const auto& [size, vector] : obstaclesBySize) {
-        possibleObstacles.push_back({size, vector});
+    auto updateSquareSizes = [&grid, &squareSizes, &reachable, stride,
+                              maxSize](int left, int top, int right, int bottom) {
+        for (int y = bottom; y >= top; --y) {
+            for (int x = right; x >= left; --x) {
+                int size{};
+                if (reachable[x + y * stride] && grid.shouldBeBlocked(grid.toIndex(x, y))) {
+                    const auto smallest{std::min({squareSizes[(x + 1) + y * stride],
+                                                  squareSizes[x + (y + 1) * stride],
+                                                  squareSizes[(x + 1) + (y + 1) * stride]})};
+
+                    size = std::min(maxSize, smallest + 1);
+                }
+
+                squareSizes[x + y * stride] = size;
+            }
+        }
+    };
+
+    // Mountains start at zone tiles, so only squares inside zone bounds are needed.
+    // Squares are limited by the biggest mountain and never look further to the right and down
+    Position areaStart{mapSize, mapSize};
+    Position areaEnd{-1, -1};
+    for (const auto& tile : tileInfo) {
+        areaStart = Position{std::min(areaStart.x, tile.x), std::min(areaStart.y, tile.y)};
+        areaEnd = Position{std::max(areaEnd.x, tile.x), std::max(areaEnd.y, tile.y)};
     }
 
-    std::sort(possibleObstacles.begin(), possibleObstacles.end(),
-              [](const MountainPair& a, const MountainPair& b) {
-                  // Bigger mountains first
-                  return a.first > b.first;
-              });
+    areaEnd = Position{std::min(mapSize - 1, areaEnd.x + maxSize - 1),
+                       std::min(mapSize - 1, areaEnd.y + maxSize - 1)};
+
+    updateSquareSizes(areaStart.x, areaStart.y, areaEnd.x, areaEnd.y);
 
-    auto tryPlaceMountainHere = [this, &possibleObstacles](const Position& tile, int index) {
-        auto& rand{mapGenerator->randomGenerator};
+    auto tryPlaceMountainHere = [this, &possibleObstacles, &squareSizes, &updateSquareSizes,
+                                 &areaStart, &areaEnd, stride,
+                                 maxSize](const Position& tile, int index) {
+        auto& rand{randomGenerator};
 
         const auto it{getRandomElement(possibleObstacles[index].second, rand)};
 
-        const MapElement mountainElement({it->size, it->size});
-        if (!canObstacleBePlacedHere(mountainElement, tile)) {
+        if (squareSizes[tile.x + tile.y * stride] < it->size) {
             return false;
         }
 
+        const MapElement mountainElement({it->size, it->size});
+
         // If size is 3 or 5, roll 10% chance to spawn mountain landmark
         // TODO: remove hardcoded values
         if ((it->size == 3 || it->size == 5) && rand.chance(10)) {
-            auto noWrongSize = [size = it->size](const LandmarkInfo* info) {
-                return info->getSize().x != size || info->getSize().y != size;
-            };
+            const auto& landmarks{mapGenerator->getPickPools().landmarks};
 
-            auto info{pickMountainLandmark(rand, {noWrongSize})};
+            auto info{landmarks.pickMountain(it->size, it->size, rand)};
             assert(info != nullptr);
 
-            auto landmarkId{mapGenerator->createId(CMidgardID::Type::Landmark)};
+            auto landmarkId{createId(CMidgardID::Type::Landmark)};
             auto landmark{std::make_unique<Landmark>(landmarkId, info->getSize())};
             landmark->setTypeId(info->getLandmarkId());
 
@@ -367,6 +493,13 @@ void TemplateZone::createObstacles()
             placeMountain(tile, mountainElement.getSize(), it->image);
         }
 
+        // Mountain tiles are not blocked anymore,
+        // this affects squares that start above and to the left of them
+        updateSquareSizes(std::max(areaStart.x, tile.x - maxSize + 1),
+                          std::max(areaStart.y, tile.y - maxSize + 1),
+                          std::min(areaEnd.x, tile.x + it->size - 1),
+                          std::min(areaEnd.y, tile.y + it->size - 1));
+
         return true;
     };
 
@@ -419,8 +552,10 @@ void TemplateZone::createObstacles()
         return;
     }
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
+    // Tiles where forests can be placed
+    std::vector<Position> forestTiles;
     for (auto& tile : tileInfo) {
         if (mapGenerator->isPossible(tile)) {
             if (mapGenerator->isRoad(tile)) {
@@ -428,20 +563,28 @@ void TemplateZone::createObstacles()
                 continue;
             }
 
-            // Can place forests here
-            const bool shouldPlace = forests == 100 ? true : rand.chance(forests);
-            if (!shouldPlace) {
-                mapGenerator->setOccupied(tile, TileType::Free);
-                continue;
-            }
-
-            mapGenerator->setOccupied(tile, TileType::Used);
+            forestTiles.push_back(tile);
+        }
+    }
 
-            auto& mapTile = mapGenerator->map->getTile(tile);
+    std::vector<std::uint8_t> shouldPlace(forestTiles.size(), 1);
+    if (forests != 100) {
+        rand.fillChances(shouldPlace.begin(), shouldPlace.end(), forests);
+    }
 
-            mapTile.setTerrainGround(TerrainType::Neutral, GroundType::Forest);
-            mapTile.treeImage = getRandomTreeImageIndex(rand);
+    for (std::size_t i = 0; i < forestTiles.size(); ++i) {
+        const auto& tile{forestTiles[i]};
+        if (!shouldPlace[i]) {
+            mapGenerator->setOccupied(tile, TileType::Free);
+            continue;
         }
+
+        mapGenerator->setOccupied(tile, TileType::Used);
+
+        auto& mapTile = mapGenerator->map->getTile(tile);
+
+        mapTile.setTerrainGround(TerrainType::Neutral, GroundType::Forest);
+        mapTile.treeImage = getRandomTreeImageIndex(rand);
     }
 }
 
@@ -451,42 +594,48 @@ void TemplateZone::connectRoads()
         std::cout << "Started building roads\n";
     }
 
-    std::set<Position> roadNodesCopy{roadNodes};
-    std::set<Position> processed;
+    // Road network is a minimum spanning tree over euclidean distances between road nodes.
+    // Using Prim's algorithm, each step connects node that is closest to already built network.
+    // Roads are searched from new node and stop at any road tile of the network
+    const std::vector<Position> nodes(roadNodes.begin(), roadNodes.end());
+    const auto total{nodes.size()};
 
-    while (!roadNodesCopy.empty()) {
-        auto node{*roadNodesCopy.begin()};
-        roadNodesCopy.erase(node);
+    // Closest network node and squared distance to it for each node not in network
+    std::vector<std::size_t> closestNodes(total, 0);
+    std::vector<std::uint32_t> distances(total, std::numeric_limits<std::uint32_t>::max());
+    std::vector<bool> connected(total, false);
 
-        Position cross{-1, -1};
+    std::size_t node{0};
+    for (std::size_t step = 1; step < total; ++step) {
+        connected[node] = true;
 
-        auto comparator = [&node](const Position& a, const Position& b) {
-            return node.distanceSquared(a) < node.distanceSquared(b);
-        };
+        std::size_t next{total};
+        for (std::size_t i = 0; i < total; ++i) {
+            if (connected[i]) {
+                continue;
+            }
 
-        if (!processed.empty()) {
-            // Connect with existing network
-            cross = *std::min_element(processed.begin(), processed.end(), comparator);
-        } else if (!roadNodesCopy.empty()) {
-            // Connect with any other unconnected node
-            cross = *std::min_element(roadNodesCopy.begin(), roadNodesCopy.end(), comparator);
-        } else {
-            // No other nodes left, for example single road node in this zone
-            break;
-        }
+            const auto distance{nodes[node].distanceSquared(nodes[i])};
+            if (distance < distances[i]) {
+                distances[i] = distance;
+                closestNodes[i] = node;
+            }
 
-        if (mapGenerator->isDebugMode()) {
-            std::cout << "Building road from " << node << " to " << cross << '\n';
+            if (next == total || distances[i] < distances[next]) {
+                next = i;
+            }
         }
 
-        if (createRoad(node, cross)) {
-            // Don't draw road starting at end point which is already connected
-            processed.insert(cross);
+        const auto& source{nodes[next]};
+        const auto& cross{nodes[closestNodes[next]]};
 
-            eraseIfPresent(roadNodesCopy, cross);
+        if (mapGenerator->isDebugMode()) {
+            std::cout << "Building road from " << source << " to " << cross << '\n';
         }
 
-        processed.insert(node);
+        // Node joins the network even if road could not be built
+        createRoad(source, cross);
+        node = next;
     }
 
     if (mapGenerator->isDebugMode()) {
@@ -663,9 +812,9 @@ void TemplateZone::placeObject(std::unique_ptr<Fortification>&& fortification,
     // Add road node using entrance point
     addRoadNode(fortification->getEntrance());
 
-    mapGenerator->map->insertMapElement(*fortification.get(), fortification->getId());
+    insertMapElement(*fortification.get(), fortification->getId());
     // Store object in scenario map
-    mapGenerator->insertObject(std::move(fortification));
+    insertObject(std::move(fortification));
 }
 
 void TemplateZone::placeObject(std::unique_ptr<Stack>&& stack,
@@ -698,9 +847,9 @@ void TemplateZone::placeObject(std::unique_ptr<Stack>&& stack,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*stack.get(), stack->getId());
+    insertMapElement(*stack.get(), stack->getId());
     // Store object in scenario map
-    mapGenerator->insertObject(std::move(stack));
+    insertObject(std::move(stack));
 }
 
 void TemplateZone::placeObject(std::unique_ptr<Crystal>&& crystal,
@@ -733,9 +882,9 @@ void TemplateZone::placeObject(std::unique_ptr<Crystal>&& crystal,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*crystal.get(), crystal->getId());
+    insertMapElement(*crystal.get(), crystal->getId());
     // Store object in scenario map
-    mapGenerator->insertObject(std::move(crystal));
+    insertObject(std::move(crystal));
 }
 
 void TemplateZone::placeObject(std::unique_ptr<Ruin>&& ruin,
@@ -780,9 +929,9 @@ void TemplateZone::placeObject(std::unique_ptr<Ruin>&& ruin,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*ruin.get(), ruin->getId());
+    insertMapElement(*ruin.get(), ruin->getId());
     // Store object in scenario map
-    mapGenerator->insertObject(std::move(ruin));
+    insertObject(std::move(ruin));
 }
 
 void TemplateZone::placeObject(std::unique_ptr<Site>&& site,
@@ -830,9 +979,9 @@ void TemplateZone::placeObject(std::unique_ptr<Site>&& site,
     // Add road node using entrance point
     addRoadNode(site->getEntrance());
 
-    mapGenerator->map->insertMapElement(*site.get(), site->getId());
+    insertMapElement(*site.get(), site->getId());
     // Store object in scenario map
-    mapGenerator->insertObject(std::move(site));
+    insertObject(std::move(site));
 }
 
 void TemplateZone::placeObject(std::unique_ptr<Bag>&& bag,
@@ -865,9 +1014,9 @@ void TemplateZone::placeObject(std::unique_ptr<Bag>&& bag,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*bag.get(), bag->getId());
+    insertMapElement(*bag.get(), bag->getId());
     // Store object in scenario map
-    mapGenerator->insertObject(std::move(bag));
+    insertObject(std::move(bag));
 }
 
 void TemplateZone::placeObject(std::unique_ptr<Landmark>&& landmark,
@@ -913,9 +1062,9 @@ void TemplateZone::placeObject(std::unique_ptr<Landmark>&& landmark,
         updateDistances(position);
     }
 
-    mapGenerator->map->insertMapElement(*landmark.get(), landmark->getId());
+    insertMapElement(*landmark.get(), landmark->getId());
     // Store object in scenario map
-    mapGenerator->insertObject(std::move(landmark));
+    insertObject(std::move(landmark));
 }
 
 void TemplateZone::placeMountain(const Position& position, const Position& size, int image)
@@ -934,7 +1083,7 @@ void TemplateZone::placeMountain(const Position& position, const Position& size,
         }
     }
 
-    mapGenerator->map->addMountain(position, size, image);
+    newMountains.push_back({position, size, image});
 }
 
 bool TemplateZone::guardObject(const MapElement& mapElement, const GroupInfo& guardInfo)
@@ -973,11 +1122,64 @@ bool TemplateZone::guardObject(const MapElement& mapElement, const GroupInfo& gu
 
 void TemplateZone::updateDistances(const Position& position)
 {
-    for (auto& tile : possibleTiles) {
+    if (possibleTiles.empty()) {
+        return;
+    }
+
+    auto& tiles{mapGenerator->tiles};
+
+    auto updateDistance = [this, &tiles, &position](const Position& tile) {
+        const auto index{tiles.toIndex(tile)};
         const auto distance{static_cast<float>(position.distanceSquared(tile))};
-        const auto currentDistance{mapGenerator->getNearestObjectDistance(tile)};
+        const auto currentDistance{tiles.getNearestObjectDistance(index)};
 
-        mapGenerator->setNearestObjectDistance(tile, std::min(distance, currentDistance));
+        if (distance < currentDistance) {
+            possibleTilesByDistance.erase({currentDistance, tile});
+            possibleTilesByDistance.insert({distance, tile});
+            tiles.setNearestObjectDistance(index, distance);
+        }
+    };
+
+    // Only tiles that are closer to the position than to their nearest objects are updated.
+    // They all lie within the radius of the largest distance
+    const auto maxDistance{possibleTilesByDistance.begin()->first};
+    const auto radius{static_cast<int>(std::sqrt(maxDistance)) + 1};
+    const auto mapSize{tiles.getSize()};
+
+    const auto minX{std::max(0, position.x - radius)};
+    const auto maxX{std::min(mapSize - 1, position.x + radius)};
+    const auto minY{std::max(0, position.y - radius)};
+    const auto maxY{std::min(mapSize - 1, position.y + radius)};
+
+    const auto width{static_cast<std::size_t>(std::max(0, maxX - minX + 1))};
+    const auto height{static_cast<std::size_t>(std::max(0, maxY - minY + 1))};
+
+    if (width * height >= possibleTiles.size()) {
+        // Zone tiles are always on the map, no need to check them
+        for (const auto& tile : possibleTiles) {
+            updateDistance(tile);
+        }
+
+        return;
+    }
+
+    for (int y = minY; y <= maxY; ++y) {
+        for (int x = minX; x <= maxX; ++x) {
+            const Position tile{x, y};
+            if (tiles.getZoneId(tiles.toIndex(tile)) == id && possibleTiles.count(tile)) {
+                updateDistance(tile);
+            }
+        }
+    }
+}
+
+void TemplateZone::erasePossibleTile(const Position& position)
+{
+    if (possibleTiles.erase(position)) {
+        const auto& tiles{mapGenerator->tiles};
+        const auto distance{tiles.getNearestObjectDistance(tiles.toIndex(position))};
+
+        possibleTilesByDistance.erase({distance, position});
     }
 }
 
@@ -996,87 +1198,81 @@ bool TemplateZone::connectWithCenter(const Position& position,
                                      bool onlyStraight,
                                      bool passThroughBlocked)
 {
-    // A* algorithm
+    auto& grid{mapGenerator->tiles};
+    const auto start{grid.toIndex(position)};
+    const auto center{grid.toIndex(pos)};
+
+    // Returns cost of entering the tile or zero if tile can not be entered
+    auto getMovementCost = [this, &grid, passThroughBlocked](std::size_t index) {
+        if (grid.getZoneId(index) != id) {
+            return 0.f;
+        }
+
+        // We prefer to use already free paths
+        if (grid.isFree(index)) {
+            return 1.f;
+        }
 
-    // Nodes that are already evaluated
-    std::set<Position> closed;
-    // The set of tentative nodes to be evaluated, initially containing the start node
-    PriorityQueue queue;
-    // Map of navigated nodes
-    std::map<Position, Position> cameFrom;
-    std::map<Position, float> distances;
+        if (grid.isPossible(index)) {
+            return 2.f;
+        }
 
-    // First node points to finish condition.
-    // Invalid position of (-1 -1) used as stop element
-    cameFrom[position] = Position(-1, -1);
-    queue.push(std::make_pair(position, 0.f));
-    distances[position] = 0.f;
+        if (passThroughBlocked && grid.shouldBeBlocked(index)) {
+            return 3.f;
+        }
 
-    while (!queue.empty()) {
-        auto node = queue.top();
-        // Remove top element
-        queue.pop();
+        return 0.f;
+    };
 
-        const auto& currentNode{node.first};
-        closed.insert(currentNode);
+    auto expand = [this, &grid, &getMovementCost, onlyStraight](std::size_t current,
+                                                               float currentDistance) {
+        if (currentDistance > pathfinder.getDistance(current)) {
+            // Tile was already expanded with better distance
+            return;
+        }
 
-        // Reached center of the zone, stop
-        if (currentNode == pos) {
-            // Trace the path using the saved parent information and return path
-            Position backTracking{currentNode};
-            while (cameFrom[backTracking].isValid()) {
-                mapGenerator->setOccupied(backTracking, TileType::Free);
-                backTracking = cameFrom[backTracking];
+        auto functor = [this, &getMovementCost, current, currentDistance](std::size_t neighbor) {
+            const float movementCost{getMovementCost(neighbor)};
+            if (movementCost > 0.f) {
+                pathfinder.relax(current, neighbor, currentDistance + movementCost);
             }
+        };
 
-            return true;
+        if (onlyStraight) {
+            grid.foreachDirectNeighbor(current, functor);
         } else {
-            auto functor = [this, &queue, &closed, &cameFrom, &currentNode, &distances,
-                            passThroughBlocked](Position& p) {
-                if (contains(closed, p)) {
-                    return;
-                }
-
-                if (mapGenerator->getZoneId(p) != id) {
-                    return;
-                }
+            grid.foreachNeighbor(current, functor);
+        }
+    };
 
-                float movementCost{};
-                if (mapGenerator->isFree(p)) {
-                    movementCost = 1.f;
-                } else if (mapGenerator->isPossible(p)) {
-                    movementCost = 2.f;
-                } else if (passThroughBlocked && mapGenerator->shouldBeBlocked(p)) {
-                    movementCost = 3.f;
-                } else {
-                    return;
-                }
+    // Start tile is left as is
+    auto markPath = [&grid, start](std::size_t index) {
+        if (index != start) {
+            grid.setOccupied(index, TileType::Free);
+        }
+    };
 
-                // We prefer to use already free paths
-                const float distance{distances[currentNode] + movementCost};
-                auto bestDistanceSoFar{std::numeric_limits<int>::max()};
+    auto isGoal = [center](std::size_t index) {
+        // Reached center of the zone, stop
+        return index == center;
+    };
 
-                auto it{distances.find(p)};
-                if (it != distances.end()) {
-                    bestDistanceSoFar = static_cast<int>(it->second);
-                }
+    // Each step costs at least 1, so number of steps to the center never overestimates
+    auto heuristic = [&grid, centerPosition = pos, onlyStraight](std::size_t index) {
+        const auto tile{grid.toPosition(index)};
+        const int dx{std::abs(tile.x - centerPosition.x)};
+        const int dy{std::abs(tile.y - centerPosition.y)};
 
-                if (distance < bestDistanceSoFar) {
-                    cameFrom[p] = currentNode;
-                    queue.push(std::make_pair(p, distance));
-                    distances[p] = distance;
-                }
-            };
+        return static_cast<float>(onlyStraight ? dx + dy : std::max(dx, dy));
+    };
 
-            if (onlyStraight) {
-                mapGenerator->foreachDirectNeighbor(currentNode, functor);
-            } else {
-                mapGenerator->foreachNeighbor(currentNode, functor);
-            }
-        }
+    const auto goal{pathfinder.search(start, isGoal, expand, heuristic)};
+    if (goal == GridPathfinder::noTile) {
+        return false;
     }
 
-    return false;
+    pathfinder.tracePath(goal, markPath);
+    return true;
 }
 
 bool TemplateZone::crunchPath(const Position& source,
@@ -1098,27 +1294,24 @@ bool TemplateZone::crunchPath(const Position& source,
 
         auto lastDistance{distance};
 
+        // Stop checking neighbors as soon as destination or free path is reached
         auto processNeighbors = [this, &currentPosition, &destination, &distance, &result, &end,
                                  clearedTiles](Position& position) {
-            if (result) {
-                return;
-            }
-
             if (position == destination) {
                 result = true;
                 end = true;
             }
 
             if (position.distanceSquared(destination) >= distance) {
-                return;
+                return result;
             }
 
             if (mapGenerator->isBlocked(position)) {
-                return;
+                return result;
             }
 
             if (mapGenerator->getZoneId(position) != id) {
-                return;
+                return result;
             }
 
             if (mapGenerator->isPossible(position)) {
@@ -1133,6 +1326,8 @@ bool TemplateZone::crunchPath(const Position& source,
                 end = true;
                 result = true;
             }
+
+            return result;
         };
 
         if (onlyStraight) {
@@ -1203,83 +1398,96 @@ bool TemplateZone::crunchPath(const Position& source,
 
 bool TemplateZone::connectPath(const Position& source, bool onlyStraight)
 {
-    // A* algorithm
-
-    // The set of nodes already evaluated
-    std::set<Position> closed;
-    // The set of tentative nodes to be evaluated, initially containing the start node
-    PriorityQueue open;
-    // The map of navigated nodes
-    std::map<Position, Position> cameFrom;
-    std::map<Position, float> distances;
-
-    // First node points to finish condition
-    cameFrom[source] = Position{-1, -1};
-    distances[source] = 0.f;
-    open.push({source, 0.f});
+    auto& grid{mapGenerator->tiles};
+    const auto start{grid.toIndex(source)};
+
+    if (onlyStraight) {
+        // Distances to free paths are already known, follow them down to the closest free tile
+        auto& field{freePathField};
+        field.update();
+
+        std::size_t current{start};
+        int distance{grid.isFree(start) ? 0 : FreePathField::unreachable};
+        if (distance != 0) {
+            grid.foreachDirectNeighbor(start, [this, &grid, &field, &current,
+                                               &distance](std::size_t neighbor) {
+                if (grid.getZoneId(neighbor) == id && field.getDistance(neighbor) < distance) {
+                    distance = field.getDistance(neighbor);
+                    current = neighbor;
+                }
+            });
+        }
 
-    // Cost from start along best known path.
-    // Estimated total cost from start to goal through y.
+        if (distance != FreePathField::unreachable) {
+            grid.setOccupied(start, TileType::Free);
 
-    while (!open.empty()) {
-        auto node{open.top()};
-        open.pop();
-        const auto currentNode{node.first};
+            // Field is not changed until next update, tiles can be marked right away
+            while (distance > 0) {
+                grid.setOccupied(current, TileType::Free);
 
-        closed.insert(currentNode);
+                --distance;
+                grid.foreachDirectNeighbor(current, [&grid, &field, &current,
+                                                     distance](std::size_t neighbor) {
+                    if (field.getDistance(neighbor) == distance
+                        && grid.getZoneId(neighbor) == grid.getZoneId(current)) {
+                        current = neighbor;
+                        return true;
+                    }
 
-        // We reached free paths, stop
-        if (mapGenerator->isFree(currentNode)) {
-            // Trace the path using the saved parent information and return path
-            auto backTracking{currentNode};
-            while (cameFrom[backTracking].isValid()) {
-                mapGenerator->setOccupied(backTracking, TileType::Free);
-                backTracking = cameFrom[backTracking];
+                    return false;
+                });
             }
 
-            mapGenerator->setOccupied(backTracking, TileType::Free);
             return true;
         }
 
-        auto functor = [this, &open, &closed, &cameFrom, &currentNode, &distances](Position& pos) {
-            if (contains(closed, pos)) {
-                return;
-            }
+        // Free paths can not be reached, search below will find sealed off tiles
+    }
 
-            // No paths through blocked or occupied tiles, stay within zone
-            if (mapGenerator->isBlocked(pos) || mapGenerator->getZoneId(pos) != id) {
-                return;
-            }
+    auto isGoal = [&grid](std::size_t index) {
+        // We reached free paths, stop
+        return grid.isFree(index);
+    };
 
-            const auto distance{static_cast<int>(distances[currentNode]) + 1};
-            int bestDistanceSoFar{std::numeric_limits<int>::max()};
+    auto expand = [this, &grid, onlyStraight](std::size_t current, float currentDistance) {
+        if (currentDistance > pathfinder.getDistance(current)) {
+            // Tile was already expanded with better distance
+            return;
+        }
 
-            auto it{distances.find(pos)};
-            if (it != distances.end()) {
-                bestDistanceSoFar = static_cast<int>(it->second);
+        auto functor = [this, &grid, current, currentDistance](std::size_t neighbor) {
+            // No paths through blocked or occupied tiles, stay within zone
+            if (grid.isBlocked(neighbor) || grid.getZoneId(neighbor) != id) {
+                return;
             }
 
-            if (distance < bestDistanceSoFar) {
-                cameFrom[pos] = currentNode;
-                open.push({pos, static_cast<float>(distance)});
-                distances[pos] = static_cast<float>(distance);
-            }
+            pathfinder.relax(current, neighbor, currentDistance + 1.f);
         };
 
         if (onlyStraight) {
-            mapGenerator->foreachDirectNeighbor(currentNode, functor);
+            grid.foreachDirectNeighbor(current, functor);
         } else {
-            mapGenerator->foreachNeighbor(currentNode, functor);
+            grid.foreachNeighbor(current, functor);
         }
+    };
+
+    const auto goal{pathfinder.search(start, isGoal, expand)};
+    if (goal != GridPathfinder::noTile) {
+        pathfinder.tracePath(goal, [&grid](std::size_t index) {
+            grid.setOccupied(index, TileType::Free);
+        });
+
+        grid.setOccupied(start, TileType::Free);
+        return true;
     }
 
     // These tiles are sealed off and can't be connected anymore
-    for (const auto& tile : closed) {
-        if (mapGenerator->isPossible(tile)) {
-            mapGenerator->setOccupied(tile, TileType::Blocked);
+    for (const auto index : pathfinder.getClosedTiles()) {
+        if (grid.isPossible(index)) {
+            grid.setOccupied(index, TileType::Blocked);
         }
 
-        eraseIfPresent(possibleTiles, tile);
+        erasePossibleTile(grid.toPosition(index));
     }
 
     return false;
@@ -1292,9 +1500,97 @@ std::unique_ptr<Stack> TemplateZone::createStack(const GroupInfo& stackInfo, boo
         return nullptr;
     }
 
-    auto& rand{mapGenerator->randomGenerator};
+    const auto minValue{static_cast<int>(stackValue.min)};
+    const auto maxValue{static_cast<int>(stackValue.max)};
+
+    // Sample leader and soldiers with total value in stack value range
+    StackComposition composition;
+    const auto& compositions{
+        mapGenerator->getStackCompositions(stackInfo.subraceTypes, maxValue)};
+    if (!compositions.pick(composition, minValue, maxValue, randomGenerator)) {
+        // Value range is too tight for units of allowed subraces, pick them one by one
+        composition = pickStackUnits(stackInfo);
+    }
 
-    int strength = static_cast<int>(rand.pickValue(stackValue));
+    const UnitInfo* leaderInfo{composition.leader};
+    const auto leaderPosition{composition.leaderPosition};
+    const auto& soldiers{composition.soldiers};
+
+    if (mapGenerator->isDebugMode()) {
+        // +1 because of leader
+        int unitsCreated{1};
+        int createdValue = leaderInfo->getValue();
+
+        for (std::size_t position = 0; position < soldiers.size(); ++position) {
+            const auto* unitInfo{soldiers[position]};
+            if (!unitInfo) {
+                continue;
+            }
+
+            ++unitsCreated;
+            createdValue += unitInfo->getValue();
+
+            if (unitInfo->isBig()) {
+                // Skip second part of big unit
+                ++position;
+            }
+        }
+
+        std::cout << "Stack value " << minValue << " - " << maxValue << ", created "
+                  << createdValue << ". Units created " << unitsCreated << '\n';
+    }
+
+    auto stack{createStack(*leaderInfo, leaderPosition, soldiers, neutralOwner)};
+
+    // Make sure we create leader with correct leadership value
+    int leadershipRequired = leaderInfo->isBig() ? 2 : 1;
+
+    for (std::size_t position = 0; position < soldiers.size(); ++position) {
+        const auto* unitInfo{soldiers[position]};
+        if (!unitInfo) {
+            continue;
+        }
+
+        ++leadershipRequired;
+
+        if (unitInfo->isBig()) {
+            ++leadershipRequired;
+            // Skip second part of big unit
+            ++position;
+        }
+    }
+
+    if (leaderInfo->getLeadership() < leadershipRequired) {
+        const int diff = leadershipRequired - leaderInfo->getLeadership();
+        Unit* leaderUnit = findObject<Unit>(stack->getLeader());
+
+        for (int i = 0; i < diff; ++i) {
+            leaderUnit->addModifier(CMidgardID("G000UM9031")); // +1 Leadership
+        }
+    }
+
+    auto stackLoot{createLoot(stackInfo.loot)};
+    auto& stackInventory{stack->getInventory()};
+
+    for (const auto& [id, amount] : stackLoot) {
+        for (int i = 0; i < amount; ++i) {
+            auto itemId{createId(CMidgardID::Type::Item)};
+            auto item{std::make_unique<Item>(itemId)};
+            item->setItemType(id);
+
+            insertObject(std::move(item));
+            stackInventory.add(itemId);
+        }
+    }
+
+    return stack;
+}
+
+StackComposition TemplateZone::pickStackUnits(const GroupInfo& stackInfo)
+{
+    auto& rand{randomGenerator};
+
+    int strength = static_cast<int>(rand.pickValue(stackInfo.value));
 
     // Roll number of units
     int soldiersStrength{strength - getGameInfo()->getMinLeaderValue()};
@@ -1350,7 +1646,10 @@ std::unique_ptr<Stack> TemplateZone::createStack(const GroupInfo& stackInfo, boo
         positions.erase(leaderPosition);
     }
 
-    GroupUnits soldiers = {{nullptr, nullptr, nullptr, nullptr, nullptr, nullptr}};
+    StackComposition composition;
+    composition.leader = leaderInfo;
+    composition.leaderPosition = leaderPosition;
+    auto& soldiers{composition.soldiers};
 
     // Pick soldier units 1 by 1, starting from value that was not used for leader
     if (valuesConsumed < unitValues.size()) {
@@ -1365,75 +1664,7 @@ std::unique_ptr<Stack> TemplateZone::createStack(const GroupInfo& stackInfo, boo
     // and reduce number of stacks with single ranged or support leader
     tightenGroup(unusedValue, positions, soldiers, stackInfo.subraceTypes);
 
-    if (mapGenerator->isDebugMode()) {
-        // +1 because of leader
-        int unitsCreated{1};
-        int createdValue = leaderInfo->getValue();
-
-        for (std::size_t position = 0; position < soldiers.size(); ++position) {
-            const auto* unitInfo{soldiers[position]};
-            if (!unitInfo) {
-                continue;
-            }
-
-            ++unitsCreated;
-            createdValue += unitInfo->getValue();
-
-            if (unitInfo->isBig()) {
-                // Skip second part of big unit
-                ++position;
-            }
-        }
-
-        std::cout << "Stack value " << strength << ", created " << createdValue << ", unused "
-                  << strength - createdValue << ". Units " << unitsTotal << ", created "
-                  << unitsCreated << '\n';
-    }
-
-    auto stack{createStack(*leaderInfo, leaderPosition, soldiers, neutralOwner)};
-
-    // Make sure we create leader with correct leadership value
-    int leadershipRequired = leaderInfo->isBig() ? 2 : 1;
-
-    for (std::size_t position = 0; position < soldiers.size(); ++position) {
-        const auto* unitInfo{soldiers[position]};
-        if (!unitInfo) {
-            continue;
-        }
-
-        ++leadershipRequired;
-
-        if (unitInfo->isBig()) {
-            ++leadershipRequired;
-            // Skip second part of big unit
-            ++position;
-        }
-    }
-
-    if (leaderInfo->getLeadership() < leadershipRequired) {
-        const int diff = leadershipRequired - leaderInfo->getLeadership();
-        Unit* leaderUnit = mapGenerator->map->find<Unit>(stack->getLeader());
-
-        for (int i = 0; i < diff; ++i) {
-            leaderUnit->addModifier(CMidgardID("G000UM9031")); // +1 Leadership
-        }
-    }
-
-    auto stackLoot{createLoot(stackInfo.loot)};
-    auto& stackInventory{stack->getInventory()};
-
-    for (const auto& [id, amount] : stackLoot) {
-        for (int i = 0; i < amount; ++i) {
-            auto itemId{mapGenerator->createId(CMidgardID::Type::Item)};
-            auto item{std::make_unique<Item>(itemId)};
-            item->setItemType(id);
-
-            mapGenerator->insertObject(std::move(item));
-            stackInventory.add(itemId);
-        }
-    }
-
-    return stack;
+    return composition;
 }
 
 std::unique_ptr<Stack> TemplateZone::createStack(const UnitInfo& leaderInfo,
@@ -1441,24 +1672,24 @@ std::unique_ptr<Stack> TemplateZone::createStack(const UnitInfo& leaderInfo,
                                                  const GroupUnits& groupUnits,
                                                  bool neutralOwner)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Create stack
-    auto stackId{mapGenerator->createId(CMidgardID::Type::Stack)};
+    auto stackId{createId(CMidgardID::Type::Stack)};
     auto stack{std::make_unique<Stack>(stackId)};
 
     stack->setMove(leaderInfo.getMove());
     stack->setFacing(getRandomFacing(rand));
 
     // Create leader unit
-    auto leaderId{mapGenerator->createId(CMidgardID::Type::Unit)};
+    auto leaderId{createId(CMidgardID::Type::Unit)};
     auto leader{std::make_unique<Unit>(leaderId)};
 
     leader->setImplId(leaderInfo.getUnitId());
     leader->setHp(leaderInfo.getHp());
     leader->setName(getUnitName(leaderInfo, rand, neutralOwner));
 
-    mapGenerator->insertObject(std::move(leader));
+    insertObject(std::move(leader));
 
     const auto leaderAdded = stack->addLeader(leaderId, leaderPosition, leaderInfo.isBig());
     assert(leaderAdded);
@@ -1473,7 +1704,7 @@ const UnitInfo* TemplateZone::createStackLeader(std::size_t& unusedValue,
                                                 const std::vector<std::size_t>& unitValues,
                                                 const std::set<SubRaceType>& allowedSubraces)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // How many failed attempts considered as a stop condition
     constexpr std::size_t totalFails{5};
@@ -1492,23 +1723,9 @@ const UnitInfo* TemplateZone::createStackLeader(std::size_t& unusedValue,
             const std::size_t value = unitValues[i] + unused;
             const float minValue = value * minValueCoeff;
 
-            auto filter = [allowedSubraces, minValue, value](const UnitInfo* info) {
-                if (!allowedSubraces.empty()) {
-                    if (!contains(allowedSubraces, info->getSubrace())) {
-                        return true;
-                    }
-                }
-
-                return static_cast<float>(info->getValue()) < minValue || info->getValue() > value;
-            };
-
-            auto noForbiddenOnTemplate = [this](const UnitInfo* info) {
-                return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenUnits,
-                                info->getUnitId());
-            };
-
-            const UnitInfo* leaderInfo{
-                pickLeader(rand, {filter, noForbiddenOnTemplate, noForbiddenUnit})};
+            // Forbidden leaders are already excluded from index
+            const UnitInfo* leaderInfo{mapGenerator->getPickPools().leaders.pick(
+                allowedSubraces, AnyUnits, minValue, value, rand)};
             if (leaderInfo) {
                 // Accumulate unused value after picking a leader
                 unusedValue = value - leaderInfo->getValue();
@@ -1551,17 +1768,13 @@ void TemplateZone::createGroup(std::size_t& unusedValue,
                                const std::vector<std::size_t>& unitValues,
                                const std::set<SubRaceType>& allowedSubraces)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Pick soldier units 1 by 1, starting from value that was not used for leader
     for (std::size_t i = 0; i < unitValues.size() && !positions.empty(); ++i) {
         auto value = unitValues[i] + unusedValue;
         auto minValue = value * 0.75f;
 
-        auto noWrongValue = [minValue, value](const UnitInfo* info) {
-            return info->getValue() < minValue || info->getValue() > value;
-        };
-
         // Pick random position in group
         int position = *getRandomElement(positions, rand);
         // If front line, pick melee only
@@ -1571,44 +1784,15 @@ void TemplateZone::createGroup(std::size_t& unusedValue,
         // We can place big unit if front and back line positions are free
         const auto canPlaceBig = positions.count(position) && positions.count(secondPosition);
 
-        auto filter = [allowedSubraces, canPlaceBig, frontline](const UnitInfo* info) {
-            if (!allowedSubraces.empty()) {
-                if (allowedSubraces.find(info->getSubrace()) == allowedSubraces.end()) {
-                    // Remove units of subraces that are not allowed
-                    return true;
-                }
-            }
-
-            if (!canPlaceBig && info->isBig()) {
-                // Remove big units if we can not place them
-                return true;
-            }
-
-            // We don't care about front or back line and unit attack reach in case of big unit
-            if (canPlaceBig) {
-                return false;
-            }
-
-            if (frontline && info->getAttackReach() != ReachType::Adjacent) {
-                // Remove ranged units from frontline
-                return true;
-            }
-
-            if (!frontline && info->getAttackReach() == ReachType::Adjacent) {
-                // Remove melee units from backline
-                return true;
-            }
-
-            return false;
-        };
-
-        auto noForbiddenOnTemplate = [this](const UnitInfo* info) {
-            return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenUnits,
-                            info->getUnitId());
-        };
+        // Big unit can be placed at any line, otherwise unit attack reach should fit the line
+        std::uint8_t unitClasses{AnyUnits};
+        if (!canPlaceBig) {
+            unitClasses = frontline ? SmallMeleeUnits : SmallRangedUnits;
+        }
 
-        const UnitInfo* info = pickUnit(rand, {filter, noWrongValue, noForbiddenOnTemplate,
-                                               noForbiddenUnit});
+        // Forbidden soldiers are already excluded from index
+        const auto& soldiers{mapGenerator->getPickPools().soldiers};
+        const UnitInfo* info = soldiers.pick(allowedSubraces, unitClasses, minValue, value, rand);
         if (info) {
             // We picked a unit, update unused value
             unusedValue = value - info->getValue();
@@ -1647,7 +1831,7 @@ void TemplateZone::tightenGroup(std::size_t& unusedValue,
                                 GroupUnits& groupUnits,
                                 const std::set<SubRaceType>& allowedSubraces)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Start with somewhat relaxed minimum value.
     // Gradually decrease min value expectation as we struggle to pick units
@@ -1662,10 +1846,6 @@ void TemplateZone::tightenGroup(std::size_t& unusedValue,
         auto value = unusedValue;
         auto minValue = value * minValueCoeff;
 
-        auto noWrongValue = [minValue, value](const UnitInfo* info) {
-            return info->getValue() < minValue || info->getValue() > value;
-        };
-
         int position = *getRandomElement(positions, rand);
 
         const auto frontline = position % 2 == 0;
@@ -1674,44 +1854,15 @@ void TemplateZone::tightenGroup(std::size_t& unusedValue,
         // We can place big unit if front and back line positions are free
         const auto canPlaceBig = positions.count(position) && positions.count(secondPosition);
 
-        auto filter = [allowedSubraces, canPlaceBig, frontline](const UnitInfo* info) {
-            if (!allowedSubraces.empty()) {
-                if (allowedSubraces.find(info->getSubrace()) == allowedSubraces.end()) {
-                    // Remove units of subraces that are not allowed
-                    return true;
-                }
-            }
-
-            if (!canPlaceBig && info->isBig()) {
-                // Remove big units if we can not place them
-                return true;
-            }
-
-            // We don't care about front or back line and unit attack reach in case of big unit
-            if (canPlaceBig) {
-                return false;
-            }
-
-            if (frontline && info->getAttackReach() != ReachType::Adjacent) {
-                // Remove ranged units from frontline
-                return true;
-            }
-
-            if (!frontline && info->getAttackReach() == ReachType::Adjacent) {
-                // Remove melee units from backline
-                return true;
-            }
-
-            return false;
-        };
-
-        auto noForbiddenOnTemplate = [this](const UnitInfo* info) {
-            return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenUnits,
-                            info->getUnitId());
-        };
+        // Big unit can be placed at any line, otherwise unit attack reach should fit the line
+        std::uint8_t unitClasses{AnyUnits};
+        if (!canPlaceBig) {
+            unitClasses = frontline ? SmallMeleeUnits : SmallRangedUnits;
+        }
 
-        const UnitInfo* info = pickUnit(rand, {filter, noWrongValue, noForbiddenOnTemplate,
-                                               noForbiddenUnit});
+        // Forbidden soldiers are already excluded from index
+        const auto& soldiers{mapGenerator->getPickPools().soldiers};
+        const UnitInfo* info = soldiers.pick(allowedSubraces, unitClasses, minValue, value, rand);
         if (info) {
             // We picked a unit, update unused value
             unusedValue = value - info->getValue();
@@ -1758,14 +1909,14 @@ void TemplateZone::createGroupUnits(Group& group, const GroupUnits& groupUnits)
         }
 
         // Create unit
-        auto unitId{mapGenerator->createId(CMidgardID::Type::Unit)};
+        auto unitId{createId(CMidgardID::Type::Unit)};
         auto unit{std::make_unique<Unit>(unitId)};
         unit->setImplId(unitInfo->getUnitId());
         unit->setLevel(unitInfo->getLevel());
         unit->setHp(unitInfo->getHp());
 
         // Add it to scenario
-        mapGenerator->insertObject(std::move(unit));
+        insertObject(std::move(unit));
 
         // Add it to group
         auto unitAdded{group.addUnit(unitId, position, unitInfo->isBig())};
@@ -1780,10 +1931,10 @@ void TemplateZone::createGroupUnits(Group& group, const GroupUnits& groupUnits)
 
 Village* TemplateZone::placeCity(const Position& position, const CityInfo& cityInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Create city of specified tier, assign position, owner, subrace
-    auto villageId{mapGenerator->createId(CMidgardID::Type::Fortification)};
+    auto villageId{createId(CMidgardID::Type::Fortification)};
     auto village{std::make_unique<Village>(villageId)};
 
     CMidgardID ownerId{mapGenerator->getPlayerId(cityInfo.owner)};
@@ -1871,11 +2022,11 @@ Village* TemplateZone::placeCity(const Position& position, const CityInfo& cityI
 
     for (const auto& [id, amount] : loot) {
         for (int i = 0; i < amount; ++i) {
-            auto itemId{mapGenerator->createId(CMidgardID::Type::Item)};
+            auto itemId{createId(CMidgardID::Type::Item)};
             auto item{std::make_unique<Item>(itemId)};
             item->setItemType(id);
 
-            mapGenerator->insertObject(std::move(item));
+            insertObject(std::move(item));
             inventory.add(itemId);
         }
     }
@@ -1899,9 +2050,9 @@ Village* TemplateZone::placeCity(const Position& position, const CityInfo& cityI
 
 Site* TemplateZone::placeMerchant(const Position& position, const MerchantInfo& merchantInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
-    auto merchantId{mapGenerator->createId(CMidgardID::Type::Site)};
+    auto merchantId{createId(CMidgardID::Type::Site)};
     auto merchant{std::make_unique<Merchant>(merchantId)};
 
     const SiteText& text = *getRandomElement(getGameInfo()->getMerchantTexts(), rand);
@@ -1935,9 +2086,9 @@ Site* TemplateZone::placeMerchant(const Position& position, const MerchantInfo&
 
 Site* TemplateZone::placeMage(const Position& position, const MageInfo& mageInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
-    auto mageId{mapGenerator->createId(CMidgardID::Type::Site)};
+    auto mageId{createId(CMidgardID::Type::Site)};
     auto mage{std::make_unique<Mage>(mageId)};
 
     const SiteText& text = *getRandomElement(getGameInfo()->getMageTexts(), rand);
@@ -1989,11 +2140,6 @@ Site* TemplateZone::placeMage(const Position& position, const MageInfo& mageInfo
             return info->getLevel() < level.min || info->getLevel() > level.max;
         };
 
-        auto noForbiddenOnTemplate = [this](const SpellInfo* info) {
-            return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenSpells,
-                            info->getSpellId());
-        };
-
         while (currentValue <= desiredValue) {
             const int remainingValue = desiredValue - currentValue;
 
@@ -2001,8 +2147,9 @@ Site* TemplateZone::placeMage(const Position& position, const MageInfo& mageInfo
                 return info->getValue() > remainingValue;
             };
 
-            auto spell{pickSpell(rand, {noWrongType, noWrongLevel, noWrongValue,
-                                        noForbiddenOnTemplate, noForbiddenSpell, noDuplicates})};
+            // Forbidden spells are already excluded from pool
+            auto spell{pickSpell(mapGenerator->getPickPools().spells, rand,
+                                 {noWrongType, noWrongLevel, noWrongValue, noDuplicates})};
             if (!spell) {
                 // Could not pick anything, stop
                 break;
@@ -2027,9 +2174,9 @@ Site* TemplateZone::placeMage(const Position& position, const MageInfo& mageInfo
 
 Site* TemplateZone::placeMercenary(const Position& position, const MercenaryInfo& mercInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
-    auto mercenaryId{mapGenerator->createId(CMidgardID::Type::Site)};
+    auto mercenaryId{createId(CMidgardID::Type::Site)};
     auto mercenary{std::make_unique<Mercenary>(mercenaryId)};
 
     const SiteText& text = *getRandomElement(getGameInfo()->getMercenaryTexts(), rand);
@@ -2091,9 +2238,9 @@ Site* TemplateZone::placeMercenary(const Position& position, const MercenaryInfo
 
 Site* TemplateZone::placeTrainer(const Position& position, const TrainerInfo& trainerInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
-    auto trainerId{mapGenerator->createId(CMidgardID::Type::Site)};
+    auto trainerId{createId(CMidgardID::Type::Site)};
     auto trainer{std::make_unique<Trainer>(trainerId)};
 
     const SiteText& text = *getRandomElement(getGameInfo()->getTrainerTexts(), rand);
@@ -2122,9 +2269,9 @@ Site* TemplateZone::placeTrainer(const Position& position, const TrainerInfo& tr
 
 Site* TemplateZone::placeMarket(const Position& position, const ResourceMarketInfo& marketInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
-    auto marketId{mapGenerator->createId(CMidgardID::Type::Site)};
+    auto marketId{createId(CMidgardID::Type::Site)};
     auto market{std::make_unique<ResourceMarket>(marketId)};
 
     const SiteText& text = *getRandomElement(getGameInfo()->getMarketTexts(), rand);
@@ -2166,9 +2313,9 @@ Site* TemplateZone::placeMarket(const Position& position, const ResourceMarketIn
 
 Ruin* TemplateZone::placeRuin(const Position& position, const RuinInfo& ruinInfo)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
-    auto ruinId{mapGenerator->createId(CMidgardID::Type::Ruin)};
+    auto ruinId{createId(CMidgardID::Type::Ruin)};
     auto ruin{std::make_unique<Ruin>(ruinId)};
 
     const SiteText& text = *getRandomElement(getGameInfo()->getRuinTexts(), rand);
@@ -2238,7 +2385,7 @@ Stack* TemplateZone::placeZoneGuard(const Position& position, const GroupInfo& g
 
 Bag* TemplateZone::placeBag(const Position& position)
 {
-    auto bagId{mapGenerator->createId(CMidgardID::Type::Bag)};
+    auto bagId{createId(CMidgardID::Type::Bag)};
     auto bag{std::make_unique<Bag>(bagId)};
 
     const auto& bags = getGeneratorSettings().bags;
@@ -2246,7 +2393,7 @@ Bag* TemplateZone::placeBag(const Position& position)
     const auto& bagImages = mapGenerator->map->getTile(position).isWater() ? bags.waterImages
                                                                            : bags.images;
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
     // Pick random bag image with respect to ground type
     bag->setImage(*getRandomElement(bagImages, rand));
 
@@ -2259,7 +2406,7 @@ Bag* TemplateZone::placeBag(const Position& position)
 std::vector<std::pair<CMidgardID, int>> TemplateZone::createLoot(const LootInfo& loot,
                                                                  bool forMerchant)
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     std::vector<std::pair<CMidgardID, int>> items;
 
@@ -2283,44 +2430,41 @@ std::vector<std::pair<CMidgardID, int>> TemplateZone::createLoot(const LootInfo&
         const int desiredValue{static_cast<int>(rand.pickValue(value))};
         int currentValue{};
 
-        auto noWrongType = [types = &loot.itemTypes, forMerchant](const ItemInfo* info) {
-            if (forMerchant && info->getItemType() == ItemType::Valuable) {
+        // Types of items that can be generated
+        std::vector<ItemType> itemTypes;
+        for (std::size_t i = 0; i <= static_cast<std::size_t>(ItemType::Special); ++i) {
+            const auto itemType{static_cast<ItemType>(i)};
+
+            if (forMerchant && itemType == ItemType::Valuable) {
                 // Do not generate valuables as merchant goods
-                return true;
+                continue;
             }
 
-            if (types->empty()) {
-                return false;
+            if (!loot.itemTypes.empty() && !contains(loot.itemTypes, itemType)) {
+                // Skip types that are not allowed
+                continue;
             }
 
-            // Remove items of types that is not allowed
-            return types->find(info->getItemType()) == types->end();
-        };
-
-        auto noForbiddenOnTemplate = [this](const ItemInfo* info) {
-            return contains(mapGenerator->mapGenOptions.mapTemplate->settings.forbiddenItems,
-                            info->getItemId());
-        };
+            itemTypes.push_back(itemType);
+        }
 
+        // If user specified single item value range, pick items only from it
         const auto& itemValue{loot.itemValue};
+        constexpr std::uint32_t maxInt{std::numeric_limits<int>::max()};
+        const int minItemValue{itemValue ? static_cast<int>(std::min(itemValue.min, maxInt))
+                                         : std::numeric_limits<int>::min()};
+        const int maxItemValue{itemValue ? static_cast<int>(std::min(itemValue.max, maxInt))
+                                         : std::numeric_limits<int>::max()};
+
+        // Special and forbidden items are already excluded from index
+        const auto& itemIndex{mapGenerator->getPickPools().items};
 
         int picked{};
         while (currentValue <= desiredValue) {
             const int remainingValue = desiredValue - currentValue;
+            const int maxValue{std::min(maxItemValue, remainingValue)};
 
-            auto noWrongValue = [remainingValue, &itemValue](const ItemInfo* info) {
-                if (itemValue
-                    && (info->getValue() < itemValue.min || info->getValue() > itemValue.max)) {
-                    // If user specified single item value range,
-                    // filter items that are outside of it
-                    return true;
-                }
-
-                return info->getValue() > static_cast<int>(remainingValue);
-            };
-
-            auto item{pickItem(rand, {noWrongType, noWrongValue, noSpecialItem,
-                                      noForbiddenOnTemplate, noForbiddenItem})};
+            auto item{itemIndex.pick(itemTypes, minItemValue, maxValue, rand)};
             if (!item) {
                 // Could not pick anything, stop
                 break;
@@ -2370,77 +2514,101 @@ void TemplateZone::fractalize()
         }
     }
 
-    std::vector<Position> clearedTiles(freePaths.begin(), freePaths.end());
-    std::set<Position> possibleTiles;
-    std::set<Position> tilesToIgnore;
+    const auto mapSize{mapGenerator->tiles.getSize()};
+    auto toIndex = [mapSize](const Position& position) {
+        return static_cast<std::size_t>(position.x + position.y * mapSize);
+    };
+
+    // Squared distances from each tile to the closest cleared tile
+    std::vector<int> distances(static_cast<std::size_t>(mapSize) * mapSize,
+                               distanceTransformInfinity);
+    for (const auto& tile : freePaths) {
+        distances[toIndex(tile)] = 0;
+    }
+
+    squaredDistanceTransform(distances, mapSize, mapSize);
 
     // TODO: move this setting into template for better zone free space control
     // TODO: adjust this setting based on template value
     // and number of objects (and their average size?)
     const float minDistance{7.5 * 10};
 
+    // Sorted the same way as tiles of the zone
+    std::vector<Position> possibleTiles;
     for (const auto& tile : tileInfo) {
         if (mapGenerator->isPossible(tile)) {
-            possibleTiles.insert(tile);
+            possibleTiles.push_back(tile);
         }
     }
 
     // This should come from zone connections
-    assert(!clearedTiles.empty());
+    assert(!freePaths.empty());
     // Connect them with a grid
     std::vector<Position> nodes;
 
     if (type != TemplateZoneType::Junction) {
+        // Tiles that are close enough to cleared tiles, they are connected already
+        std::vector<bool> tilesToIgnore(distances.size(), false);
+        bool ignoredTilesFound{};
+
+        // Only distances up to minDistance are needed to check tiles,
+        // so nodes update distances within that radius
+        const int radius{static_cast<int>(std::sqrt(minDistance))};
+
         // Junction is not fractalized,
         // has only one straight path everything else remains blocked
         while (!possibleTiles.empty()) {
             // Link tiles in random order
-            std::vector<Position> tilesToMakePath(possibleTiles.begin(), possibleTiles.end());
-            randomShuffle(tilesToMakePath, mapGenerator->randomGenerator);
+            std::vector<Position> tilesToMakePath(possibleTiles);
+            randomShuffle(tilesToMakePath, randomGenerator);
 
             Position nodeFound{-1, -1};
 
             for (const auto& tileToMakePath : tilesToMakePath) {
-                // Find closest free tile
-                float currentDistance{1e10};
-                Position closestTile{-1, -1};
-
-                for (const auto& clearTile : clearedTiles) {
-                    auto distance{static_cast<float>(tileToMakePath.distanceSquared(clearTile))};
-                    if (distance < currentDistance) {
-                        currentDistance = distance;
-                        closestTile = clearTile;
-                    }
+                const auto index{toIndex(tileToMakePath)};
 
-                    if (currentDistance <= minDistance) {
-                        // This tile is close enough. Forget about it and check next one
-                        tilesToIgnore.insert(tileToMakePath);
-                        break;
-                    }
+                if (distances[index] <= minDistance) {
+                    // This tile is close enough. Forget about it and check next one
+                    tilesToIgnore[index] = true;
+                    ignoredTilesFound = true;
+                    continue;
                 }
 
                 // If tiles is not close enough, make path to it
-                if (currentDistance > minDistance) {
-                    nodeFound = tileToMakePath;
-                    nodes.push_back(nodeFound);
-                    // From now on nearby tiles will be considered handled
-                    clearedTiles.push_back(nodeFound);
-                    // Next iteration - use already cleared tiles
-                    break;
+                nodeFound = tileToMakePath;
+                nodes.push_back(nodeFound);
+
+                // From now on nearby tiles will be considered handled
+                for (int y = -radius; y <= radius; ++y) {
+                    for (int x = -radius; x <= radius; ++x) {
+                        const Position tile{nodeFound.x + x, nodeFound.y + y};
+                        if (tile.x < 0 || tile.y < 0 || tile.x >= mapSize || tile.y >= mapSize) {
+                            continue;
+                        }
+
+                        auto& distance{distances[toIndex(tile)]};
+                        distance = std::min(distance, x * x + y * y);
+                    }
                 }
+
+                // Next iteration - use already cleared tiles
+                break;
             }
 
             // These tiles are already connected, ignore them
-            for (const auto& tileToClear : tilesToIgnore) {
-                eraseIfPresent(possibleTiles, tileToClear);
+            if (ignoredTilesFound) {
+                possibleTiles.erase(std::remove_if(possibleTiles.begin(), possibleTiles.end(),
+                                                   [&tilesToIgnore, &toIndex](const Position& tile) {
+                                                       return tilesToIgnore[toIndex(tile)];
+                                                   }),
+                                    possibleTiles.end());
+                ignoredTilesFound = false;
             }
 
             // Nothing else can be done (?)
             if (!nodeFound.isValid()) {
                 break;
             }
-
-            tilesToIgnore.clear();
         }
     }
 
@@ -2448,9 +2616,10 @@ void TemplateZone::fractalize()
     for (const auto& node : nodes) {
         auto subnodes{nodes};
 
-        std::sort(subnodes.begin(), subnodes.end(), [&node](const Position& a, const Position& b) {
-            return node.distanceSquared(a) < node.distanceSquared(b);
-        });
+        std::stable_sort(subnodes.begin(), subnodes.end(),
+                         [&node](const Position& a, const Position& b) {
+                             return node.distanceSquared(a) < node.distanceSquared(b);
+                         });
 
         std::vector<Position> nearbyNodes;
         if (subnodes.size() >= 2) {
@@ -2479,26 +2648,19 @@ void TemplateZone::fractalize()
     // Now block most distant tiles away from passages
     const float blockDistance{minDistance * 0.25f};
 
+    std::fill(distances.begin(), distances.end(), distanceTransformInfinity);
+    for (const auto& tile : freePaths) {
+        distances[toIndex(tile)] = 0;
+    }
+
+    squaredDistanceTransform(distances, mapSize, mapSize);
+
     for (const auto& tile : tileInfo) {
         if (!mapGenerator->isPossible(tile)) {
             continue;
         }
 
-        if (freePaths.count(tile)) {
-            continue;
-        }
-
-        bool closeTileFound{};
-        for (const auto& clearTile : freePaths) {
-            const auto distance{static_cast<float>(tile.distanceSquared(clearTile))};
-
-            if (distance < blockDistance) {
-                closeTileFound = true;
-                break;
-            }
-        }
-
-        if (!closeTileFound) {
+        if (static_cast<float>(distances[toIndex(tile)]) >= blockDistance) {
             // This tile is far enough from passages
             mapGenerator->setOccupied(tile, TileType::Blocked);
         }
@@ -2516,10 +2678,10 @@ void TemplateZone::fractalize()
 
 void TemplateZone::placeCapital()
 {
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Create capital id
-    auto capitalId{mapGenerator->createId(CMidgardID::Type::Fortification)};
+    auto capitalId{createId(CMidgardID::Type::Fortification)};
     // Create capital object
     auto capitalCity{std::make_unique<Capital>(capitalId)};
     auto fort{capitalCity.get()};
@@ -2576,11 +2738,11 @@ void TemplateZone::placeCapital()
 
     for (const auto& [id, amount] : loot) {
         for (int i = 0; i < amount; ++i) {
-            auto itemId{mapGenerator->createId(CMidgardID::Type::Item)};
+            auto itemId{createId(CMidgardID::Type::Item)};
             auto item{std::make_unique<Item>(itemId)};
             item->setItemType(id);
 
-            mapGenerator->insertObject(std::move(item));
+            insertObject(std::move(item));
             inventory.add(itemId);
         }
     }
@@ -2589,15 +2751,15 @@ void TemplateZone::placeCapital()
     assert(leaderInfo);
 
     // Create starting leader unit
-    auto leaderId{mapGenerator->createId(CMidgardID::Type::Unit)};
+    auto leaderId{createId(CMidgardID::Type::Unit)};
     auto leader{std::make_unique<Unit>(leaderId)};
     leader->setImplId(leaderInfo->getUnitId());
     leader->setHp(leaderInfo->getHp());
     leader->setName(getUnitName(*leaderInfo, rand, false));
-    mapGenerator->insertObject(std::move(leader));
+    insertObject(std::move(leader));
 
     // Create starting stack
-    auto stackId{mapGenerator->createId(CMidgardID::Type::Stack)};
+    auto stackId{createId(CMidgardID::Type::Stack)};
     auto stack{std::make_unique<Stack>(stackId)};
     auto leaderAdded{stack->addLeader(leaderId, 2, leaderInfo->isBig())};
     assert(leaderAdded);
@@ -2642,6 +2804,8 @@ void TemplateZone::placeCapital()
     KnownSpells* knownSpells{mapGenerator->map->find<KnownSpells>(ownerPlayer->getSpellsId())};
     assert(knownSpells);
 
+    // Starting zones of the same race share player spells
+    std::lock_guard<std::mutex> lock{mapGenerator->zonesMutex};
     for (const auto& spellId : capital.spells) {
         knownSpells->add(spellId);
     }
@@ -2866,7 +3030,7 @@ bool TemplateZone::placeMines()
         const auto resourceType{mineInfo.first};
 
         for (std::uint8_t i = 0; i < mineInfo.second; ++i) {
-            auto crystalId{mapGenerator->createId(CMidgardID::Type::Crystal)};
+            auto crystalId{createId(CMidgardID::Type::Crystal)};
             auto crystal{std::make_unique<Crystal>(crystalId)};
 
             crystal->setResourceType(resourceType);
@@ -2929,7 +3093,7 @@ void TemplateZone::placeStacks()
         }
     }
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Make sure stacks from different groups are mixed on the map
     randomShuffle(positions, rand);
@@ -2967,7 +3131,7 @@ void TemplateZone::placeStacks()
             stack->setSubrace(subraceId);
 
             if (!stackGroup.name.empty()) {
-                Unit* leader{mapGenerator->map->find<Unit>(stack->getLeader())};
+                Unit* leader{findObject<Unit>(stack->getLeader())};
                 if (leader) {
                     leader->setName(stackGroup.name);
                 }
@@ -3023,11 +3187,11 @@ void TemplateZone::placeStacks()
 
             const std::vector<CMidgardID>& loot{items[i]};
             for (const auto& itemType : loot) {
-                auto itemId{mapGenerator->createId(CMidgardID::Type::Item)};
+                auto itemId{createId(CMidgardID::Type::Item)};
                 auto item{std::make_unique<Item>(itemId)};
                 item->setItemType(itemType);
 
-                mapGenerator->insertObject(std::move(item));
+                insertObject(std::move(item));
                 inventory.add(itemId);
             }
         }
@@ -3067,7 +3231,7 @@ void TemplateZone::placeBags()
         requiredItems.insert(requiredItems.end(), amount, id);
     }
 
-    auto& rand{mapGenerator->randomGenerator};
+    auto& rand{randomGenerator};
 
     // Place required items in the bags randomly
     for (const auto& id : requiredItems) {
@@ -3111,11 +3275,11 @@ void TemplateZone::placeBags()
     for (std::size_t i = 0; i < items.size() && i < placedBags.size(); ++i) {
         const auto& bagItems = items[i];
         for (const auto& bagItemId : bagItems) {
-            auto itemId{mapGenerator->createId(CMidgardID::Type::Item)};
+            auto itemId{createId(CMidgardID::Type::Item)};
             auto item{std::make_unique<Item>(itemId)};
             item->setItemType(bagItemId);
 
-            mapGenerator->insertObject(std::move(item));
+            insertObject(std::move(item));
             placedBags[i]->add(itemId);
         }
     }
@@ -3186,7 +3350,7 @@ bool TemplateZone::createRequiredObjects()
         const MapElement requiredMapElement = objectSize.isValid() ? MapElement{objectSize}
                                                                    : *mapElement;
 
-        const auto tilesBlockedByObject{requiredMapElement.getBlockedOffsets()};
+        const auto& tilesBlockedByObject{requiredMapElement.getBlockedOffsets()};
 
         bool objectPlaced{};
         bool finished{};
@@ -3211,9 +3375,10 @@ bool TemplateZone::createRequiredObjects()
             auto targetPosition{requestedPositions.find(object.get()) != requestedPositions.end()
                                     ? requestedPositions[object.get()]
                                     : pos};
+            const auto& grid{mapGenerator->tiles};
             // Smallest distance to zone center, greatest distance to nearest object
-            auto isCloser = [this, &targetPosition, &tilesBlockedByObject](const Position& a,
-                                                                           const Position& b) {
+            auto isCloser = [&grid, &targetPosition, &tilesBlockedByObject](const Position& a,
+                                                                            const Position& b) {
                 float lDist{std::numeric_limits<float>::max()};
                 float rDist{std::numeric_limits<float>::max()};
 
@@ -3228,11 +3393,15 @@ bool TemplateZone::createRequiredObjects()
                 lDist *= (lDist > 12) ? 10 : 1;
                 rDist *= (rDist > 12) ? 10 : 1;
 
-                return (lDist * 0.5f - std::sqrt(mapGenerator->getNearestObjectDistance(a)))
-                       < (rDist * 0.5f - std::sqrt(mapGenerator->getNearestObjectDistance(b)));
+                const float lObjectDistance{grid.getNearestObjectDistance(grid.toIndex(a))};
+                const float rObjectDistance{grid.getNearestObjectDistance(grid.toIndex(b))};
+
+                return (lDist * 0.5f - std::sqrt(lObjectDistance))
+                       < (rDist * 0.5f - std::sqrt(rObjectDistance));
             };
 
-            std::sort(tiles.begin(), tiles.end(), isCloser);
+            // Stable sort keeps order of equally close tiles on all platforms
+            std::stable_sort(tiles.begin(), tiles.end(), isCloser);
 
             if (tiles.empty()) {
                 throw LackOfSpaceException(std::string("Failed to fill zone ") + std::to_string(id)
@@ -3241,7 +3410,7 @@ bool TemplateZone::createRequiredObjects()
 
             for (const auto& tile : tiles) {
                 // Code partially adapted from findPlaceForObject()
-                if (!areAllTilesAvailable(requiredMapElement, tile, tilesBlockedByObject)) {
+                if (!areAllTilesAvailable(requiredMapElement, tile)) {
                     continue;
                 }
 
@@ -3306,40 +3475,58 @@ bool TemplateZone::findPlaceForObject(const std::set<Position>& area,
                                       Position& position,
                                       bool findAccessible)
 {
-    float bestDistance{0.f};
-    bool result{};
-
-    auto blockedOffsets{mapElement.getBlockedOffsets()};
-
-    for (const auto& tile : area) {
+    auto canBePlaced = [this, &mapElement, findAccessible](const Position& tile) {
         // Avoid borders
         if (mapGenerator->map->isAtTheBorder(mapElement, tile)) {
-            continue;
+            return false;
         }
 
         if (findAccessible) {
             if (!isAccessibleFromSomewhere(mapElement, tile)) {
-                continue;
+                return false;
             }
 
             if (!isEntranceAccessible(mapElement, tile)) {
-                continue;
+                return false;
             }
         }
 
-        const bool isPossible{mapGenerator->isPossible(tile)};
-        if (!isPossible) {
-            continue;
+        if (!mapGenerator->isPossible(tile)) {
+            return false;
         }
 
-        const TileInfo& t = mapGenerator->getTile(tile);
-        const float distance{t.getNearestObjectDistance()};
+        return areAllTilesAvailable(mapElement, tile);
+    };
+
+    if (&area == &tileInfo) {
+        // All possible tiles of the zone are among possibleTiles.
+        // They are already sorted by distance, the first suitable one is the best
+        for (const auto& [distance, tile] : possibleTilesByDistance) {
+            if (distance < minDistance || distance <= 0.f) {
+                break;
+            }
+
+            if (canBePlaced(tile)) {
+                position = tile;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    float bestDistance{0.f};
+    bool result{};
+
+    for (const auto& tile : area) {
+        const float distance{mapGenerator->tiles.getNearestObjectDistance(
+            mapGenerator->posToIndex(tile))};
 
         const bool distanceMoreThanMin{distance >= minDistance};
         const bool distanceMoreThanBest{distance > bestDistance};
 
         if (distanceMoreThanMin && distanceMoreThanBest) {
-            if (areAllTilesAvailable(mapElement, tile, blockedOffsets)) {
+            if (canBePlaced(tile)) {
                 bestDistance = distance;
                 position = tile;
                 result = true;
@@ -3381,7 +3568,7 @@ bool TemplateZone::isEntranceAccessible(const MapElement& mapElement,
 Position TemplateZone::getAccessibleOffset(const MapElement& mapElement,
                                            const Position& position) const
 {
-    const auto blocked{mapElement.getBlockedOffsets()};
+    const auto& size{mapElement.getSize()};
     Position result{-1, -1};
 
     // Check tiles around mapElement possible entrance in 1 tile radius
@@ -3394,7 +3581,8 @@ Position TemplateZone::getAccessibleOffset(const MapElement& mapElement,
 
             const Position offset{Position{x, y} + mapElement.getEntranceOffset()};
 
-            if (contains(blocked, offset)) {
+            // Skip tiles covered by map element
+            if (offset.x >= 0 && offset.x < size.x && offset.y >= 0 && offset.y < size.y) {
                 continue;
             }
 
@@ -3439,52 +3627,19 @@ std::vector<Position> TemplateZone::getAccessibleTiles(const MapElement& mapElem
 }
 
 bool TemplateZone::areAllTilesAvailable(const MapElement& mapElement,
-                                        const Position& position,
-                                        const std::set<Position>& blockedOffsets) const
+                                        const Position& position) const
 {
-    for (const auto& offset : blockedOffsets) {
-        const auto t{position + offset};
+    const auto& tiles{mapGenerator->tiles};
+    const auto& size{mapElement.getSize()};
 
-        if (!mapGenerator->map->isInTheMap(t) || !mapGenerator->isPossible(t)
-            || mapGenerator->getZoneId(t) != id) {
-            // If at least one tile is not possible, object can't be placed here
-            return false;
-        }
+    // Whole map element must be within the map
+    if (position.x < 0 || position.y < 0 || position.x + size.x > tiles.getSize()
+        || position.y + size.y > tiles.getSize()) {
+        return size.x <= 0 || size.y <= 0;
     }
 
-    return true;
-}
-
-bool TemplateZone::canObstacleBePlacedHere(const MapElement& mapElement,
-                                           const Position& position) const
-{
-    // Blockmap may fit in the map, but botom-right corner does not
-    if (!mapGenerator->map->isInTheMap(position)) {
-        return false;
-    }
-
-    auto blockedOffsets{mapElement.getBlockedOffsets()};
-    for (const auto& offset : blockedOffsets) {
-        const Position t{position + offset};
-
-        if (!mapGenerator->map->isInTheMap(t)) {
-            return false;
-        }
-
-        if (!mapGenerator->shouldBeBlocked(t)) {
-            return false;
-        }
-
-        /*const auto isPossible{mapGenerator->isPossible(t)};
-        const auto shouldBeBlocked{mapGenerator->shouldBeBlocked(t)};
-
-        if (!(isPossible || shouldBeBlocked)) {
-            // If at least one tile is not possible, object can't be placed here
-            return false;
-        }*/
-    }
-
-    return true;
+    // If at least one tile is not possible or belongs to other zone, object can't be placed here
+    return tiles.isAreaPossible(tiles.toIndex(position), size, id);
 }
 
 void TemplateZone::paintZoneTerrain(TerrainType terrain, GroundType ground)
@@ -3505,113 +3660,97 @@ bool TemplateZone::isInTheZone(const Position& position) const
 
 bool TemplateZone::createRoad(const Position& source, const Position& destination)
 {
-    // A* algorithm
-
-    // The set of nodes already evaluated
-    std::set<Position> closed;
-    // The set of tentative nodes to be evaluated, initially containing the start node
-    PriorityQueue queue;
-    // The map of navigated nodes
-    std::map<Position, Position> cameFrom;
-    std::map<Position, float> distances;
+    auto& grid{mapGenerator->tiles};
+    const auto& map{*mapGenerator->map};
 
     // Just in case zone guard already has road under it
     // Road under nodes will be added at very end
     mapGenerator->setRoad(source, false);
 
-    // First node points to finish condition
-    cameFrom[source] = Position{-1, -1};
-    queue.push({source, 0.f});
-    distances[source] = 0.f;
-    // Cost from start along best known path
+    const auto target{grid.toIndex(destination)};
 
-    RoadInfo road;
-    road.source = source;
-    road.destination = destination;
-
-    while (!queue.empty()) {
-        auto node{queue.top()};
-        queue.pop();
-
-        auto& currentNode{node.first};
-        closed.insert(currentNode);
-
-        if (currentNode == destination || mapGenerator->isRoad(currentNode)) {
-            // The goal node was reached.
-            // Trace the path using the saved parent information and return path
-            Position backtracking{currentNode};
-            while (cameFrom[backtracking].isValid()) {
-                // Add node to path
-                road.path.push({backtracking, distances[backtracking]});
-                mapGenerator->setRoad(backtracking, true);
-                backtracking = cameFrom[backtracking];
-            }
-
-            roads.push_back(road);
-            return true;
-        }
+    auto isGoal = [&grid, target](std::size_t index) {
+        return index == target || grid.isRoad(index);
+    };
 
-        const auto& currentTile{mapGenerator->map->getTile(currentNode)};
+    auto expand = [this, &grid, &map, target](std::size_t current, float currentDistance) {
+        const auto currentPosition{grid.toPosition(current)};
+        const auto& currentTile{map.getTile(currentPosition)};
         bool directNeighbourFound{false};
         float movementCost{1.f};
 
-        auto functor = [this, &queue, &distances, &closed, &cameFrom, &currentNode, &currentTile,
-                        &node, &destination, &directNeighbourFound, &movementCost](Position& p) {
-            if (contains(closed, p)) {
-                // We already visited that node
-                return;
-            }
-
-            float distance{node.second + movementCost};
-            float bestDistanceSoFar{std::numeric_limits<float>::max()};
-
-            auto it{distances.find(p)};
-            if (it != distances.end()) {
-                bestDistanceSoFar = it->second;
-            }
-
-            if (distance >= bestDistanceSoFar) {
+        auto functor = [this, &grid, &map, &currentPosition, &currentTile, &directNeighbourFound,
+                        &movementCost, current, currentDistance, target](std::size_t neighbor) {
+            const float distance{currentDistance + movementCost};
+            if (!pathfinder.canImprove(neighbor, distance)) {
                 return;
             }
 
-            auto& tile{mapGenerator->map->getTile(p)};
+            const auto position{grid.toPosition(neighbor)};
+            auto& tile{map.getTile(position)};
             if (tile.isWater()) {
                 return;
             }
 
-            const auto canMoveBetween{mapGenerator->map->canMoveBetween(currentNode, p)};
+            const auto canMoveBetween{map.canMoveBetween(currentPosition, position)};
 
-            const auto emptyPath{mapGenerator->isFree(p) && mapGenerator->isFree(currentNode)};
+            const auto emptyPath{grid.isFree(neighbor) && grid.isFree(current)};
             // Moving from or to visitable object
             const auto visitable{(tile.visitable || currentTile.visitable) && canMoveBetween};
             // Already completed the path
-            const auto completed{p == destination};
+            const auto completed{neighbor == target};
 
             if (emptyPath || visitable || completed) {
                 // Otherwise guard position may appear already connected to other zone.
-                if (mapGenerator->getZoneId(p) == id || completed) {
-                    cameFrom[p] = currentNode;
-                    distances[p] = distance;
-                    queue.push({p, distance});
+                if (grid.getZoneId(neighbor) == id || completed) {
+                    pathfinder.relax(current, neighbor, distance);
                     directNeighbourFound = true;
                 }
             }
         };
 
         // Roads cannot be placed diagonally
-        mapGenerator->foreachDirectNeighbor(currentNode, functor);
+        grid.foreachDirectNeighbor(current, functor);
         if (!directNeighbourFound) {
             // Moving diagonally is penalized over moving two tiles straight
             movementCost = 2.1f;
-            mapGenerator->foreachDiagonalNeighbor(currentNode, functor);
+            grid.foreachDiagonalNeighbor(current, functor);
+        }
+    };
+
+    // No heuristic here: diagonal moves are allowed only when no straight move improves
+    // the path at the moment of expansion. Changing expansion order changes available moves
+    // and may result in a path of different cost
+    const auto goal{pathfinder.search(grid.toIndex(source), isGoal, expand)};
+    if (goal == GridPathfinder::noTile) {
+        if (mapGenerator->isDebugMode()) {
+            std::cout << "Failed create road from " << source << " to " << destination << '\n';
         }
+
+        return false;
     }
 
     if (mapGenerator->isDebugMode()) {
-        std::cout << "Failed create road from " << source << " to " << destination << '\n';
+        std::cout << "Road from " << source << " to " << destination << " built, "
+                  << pathfinder.getExpandedTiles() << " tiles expanded\n";
     }
 
-    return false;
+    // The goal node was reached.
+    // Trace the path using the saved parent information and return path
+    RoadInfo road;
+    road.source = source;
+    road.destination = destination;
+
+    pathfinder.tracePath(goal, [&grid, &road](std::size_t index) {
+        // Add node to path
+        road.path.push_back(index);
+        grid.setRoad(index, true);
+    });
+
+    // Path was traced backwards, store it starting from source
+    std::reverse(road.path.begin(), road.path.end());
+    roads.push_back(std::move(road));
+    return true;
 }
 
 } // namespace rsg
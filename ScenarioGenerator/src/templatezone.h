@@ -20,24 +20,42 @@
 #pragma once
 
 #include "decoration.h"
+#include "freepathfield.h"
 #include "gameinfo.h"
+#include "gridpathfinder.h"
 #include "position.h"
+#include "randomgenerator.h"
 #include "scenario/bag.h"
 #include "scenario/crystal.h"
 #include "scenario/fortification.h"
 #include "scenario/landmark.h"
+#include "scenario/map.h"
 #include "scenario/ruin.h"
 #include "scenario/site.h"
 #include "scenario/stack.h"
+#include "unitpicker.h"
 #include "vposition.h"
 #include "zoneoptions.h"
 #include <memory>
-#include <queue>
+#include <vector>
 
 namespace rsg {
 
 class MapGenerator;
 class UnitInfo;
+class Item;
+
+// Generation phases of zone, each phase draws random values from its own stream
+enum class ZonePhase : std::uint64_t
+{
+    Towns,
+    FreeTiles,
+    Border,
+    Connections,
+    Fill,
+    Obstacles,
+    Roads,
+};
 
 enum class ObjectPlacingResult
 {
@@ -46,21 +64,25 @@ enum class ObjectPlacingResult
     SealedOff,
 };
 
-// A* priority queue
-using Distance = std::pair<Position, float>;
-struct NodeComparer
+// Tile distance to the nearest object and its position
+using TileDistance = std::pair<float, Position>;
+
+// Orders tiles by decreasing distance to the nearest object, then by position
+struct TileDistanceComparer
 {
-    bool operator()(const Distance& a, const Distance& b) const
+    bool operator()(const TileDistance& a, const TileDistance& b) const
     {
-        return b.second < a.second;
+        if (a.first != b.first) {
+            return a.first > b.first;
+        }
+
+        return a.second < b.second;
     }
 };
 
-using PriorityQueue = std::priority_queue<Distance, std::vector<Distance>, NodeComparer>;
-
 struct RoadInfo
 {
-    PriorityQueue path; // Road tiles
+    std::vector<std::size_t> path; // Indices of road tiles in grid, ordered from source
     Position source;
     Position destination;
 };
@@ -68,9 +90,7 @@ struct RoadInfo
 // Describes zone in a template
 struct TemplateZone : public ZoneOptions
 {
-    TemplateZone(MapGenerator* mapGenerator)
-        : mapGenerator{mapGenerator}
-    { }
+    TemplateZone(MapGenerator* mapGenerator);
 
     const VPosition& getCenter() const
     {
@@ -102,7 +122,7 @@ struct TemplateZone : public ZoneOptions
     void removeTile(const Position& position)
     {
         tileInfo.erase(position);
-        possibleTiles.erase(position);
+        erasePossibleTile(position);
     }
 
     void clearTiles()
@@ -125,8 +145,53 @@ struct TemplateZone : public ZoneOptions
         ownerId = id;
     }
 
+    // Entrance is the bottom right tile of a fortification,
+    // tiles around the one diagonal to it are cleared
+    static constexpr int entranceReach{2};
+
     void clearEntrance(const Fortification& fort);
 
+    // Prepares zone to be filled independently of other zones.
+    // Zone draws random values from streams forked from its own one
+    // and creates objects with reserved identifiers
+    void prepare(const RandomGenerator& zoneStream, IdBlock&& ids);
+    // Switches zone to random stream of specified phase
+    void startPhase(ZonePhase phase)
+    {
+        randomGenerator = randomStream.fork(static_cast<std::uint64_t>(phase));
+    }
+    // Moves objects created by zone since previous commit to scenario map
+    void commitObjects();
+
+    RandomGenerator& getRandomGenerator()
+    {
+        return randomGenerator;
+    }
+
+    const GridPathfinder& getPathfinder() const
+    {
+        return pathfinder;
+    }
+
+    CMidgardID createId(CMidgardID::Type type)
+    {
+        return reservedIds.createId(type);
+    }
+
+    // Objects and map elements are stored in the zone until commitObjects()
+    void insertObject(ScenarioObjectPtr&& object);
+    void insertObject(std::unique_ptr<Item>&& item);
+    void insertMapElement(const MapElement& mapElement, const CMidgardID& mapElementId);
+
+    // Returns object created by zone or already stored in scenario map
+    template <typename T>
+    T* findObject(const CMidgardID& objectId)
+    {
+        return dynamic_cast<T*>(findObject(objectId));
+    }
+
+    ScenarioObject* findObject(const CMidgardID& objectId);
+
     void initTowns();
     void initFreeTiles();
     void createBorder();
@@ -176,6 +241,7 @@ struct TemplateZone : public ZoneOptions
     bool guardObject(const MapElement& mapElement, const GroupInfo& guardInfo);
 
     void updateDistances(const Position& position);
+    void erasePossibleTile(const Position& position);
 
     void addRoadNode(const Position& position);
 
@@ -205,6 +271,10 @@ struct TemplateZone : public ZoneOptions
                                        const GroupUnits& groupUnits,
                                        bool neutralOwner);
 
+    // Picks stack leader and soldiers one by one for rolled stack value.
+    // Used when no precomputed composition fits stack value range
+    StackComposition pickStackUnits(const GroupInfo& stackInfo);
+
     // Picks stack leader using stack unit values
     const UnitInfo* createStackLeader(std::size_t& unusedValue,
                                       std::size_t& valuesConsumed,
@@ -267,10 +337,7 @@ struct TemplateZone : public ZoneOptions
     Position getAccessibleOffset(const MapElement& mapElement, const Position& position) const;
     // Returns all tiles from which specified map element can be accessed
     std::vector<Position> getAccessibleTiles(const MapElement& mapElement) const;
-    bool areAllTilesAvailable(const MapElement& mapElement,
-                              const Position& position,
-                              const std::set<Position>& blockedOffsets) const;
-    bool canObstacleBePlacedHere(const MapElement& mapElement, const Position& position) const;
+    bool areAllTilesAvailable(const MapElement& mapElement, const Position& position) const;
 
     void paintZoneTerrain(TerrainType terrain, GroundType ground);
 
@@ -284,6 +351,26 @@ private:
 
     MapGenerator* mapGenerator{};
 
+    // Generation state of the zone, zones do not share it
+    RandomGenerator randomStream;    // Random streams of phases are forked from it
+    RandomGenerator randomGenerator; // Stream of current phase
+    IdBlock reservedIds;
+    GridPathfinder pathfinder; // Used for all path searches in zone
+    FreePathField freePathField;
+
+    struct MountainPlacement
+    {
+        Position position;
+        Position size;
+        int image{};
+    };
+
+    // Created objects that are not stored in scenario map yet
+    std::vector<ScenarioObjectPtr> newObjects;
+    std::vector<std::pair<const MapElement*, CMidgardID>> newMapElements;
+    std::vector<MountainPlacement> newMountains;
+    std::vector<CMidgardID> newTalismans;
+
     // Template info
     TerrainType terrainType{TerrainType::Neutral};
 
@@ -307,6 +394,8 @@ private:
     VPosition center;
     std::set<Position> tileInfo;      // Area assigned to zone
     std::set<Position> possibleTiles; // For treasure generation
+    // Same tiles as possibleTiles, ordered for fast search of the most distant ones
+    std::set<TileDistance, TileDistanceComparer> possibleTilesByDistance;
     std::set<Position> freePaths;     // Paths of free tiles that all objects will be linked to
     std::set<Position> roadNodes;     // Tiles to be connected with roads
 
@@ -0,0 +1,114 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "threadpool.h"
+
+namespace rsg {
+
+ThreadPool::ThreadPool(std::size_t threadsTotal)
+{
+    for (std::size_t i = 1; i < threadsTotal; ++i) {
+        workers.emplace_back(&ThreadPool::work, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock{mutex};
+        stopping = true;
+    }
+
+    batchStarted.notify_all();
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+void ThreadPool::run(std::size_t total, const std::function<void(std::size_t)>& task)
+{
+    std::unique_lock<std::mutex> lock{mutex};
+
+    currentTask = &task;
+    errors.assign(total, nullptr);
+    tasksTotal = total;
+    nextTask = 0;
+    tasksLeft = total;
+    ++batch;
+
+    batchStarted.notify_all();
+
+    runTasks(lock);
+    batchFinished.wait(lock, [this]() { return tasksLeft == 0; });
+
+    currentTask = nullptr;
+
+    for (const auto& error : errors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+}
+
+void ThreadPool::work()
+{
+    std::unique_lock<std::mutex> lock{mutex};
+    std::size_t finishedBatch{batch};
+
+    while (true) {
+        batchStarted.wait(lock, [this, finishedBatch]() {
+            return stopping || batch != finishedBatch;
+        });
+
+        if (stopping) {
+            return;
+        }
+
+        finishedBatch = batch;
+        runTasks(lock);
+    }
+}
+
+void ThreadPool::runTasks(std::unique_lock<std::mutex>& lock)
+{
+    while (nextTask < tasksTotal) {
+        const auto index{nextTask++};
+        const auto& task{*currentTask};
+
+        lock.unlock();
+
+        std::exception_ptr error;
+        try {
+            task(index);
+        } catch (...) {
+            error = std::current_exception();
+        }
+
+        lock.lock();
+
+        errors[index] = error;
+        if (--tasksLeft == 0) {
+            batchFinished.notify_all();
+        }
+    }
+}
+
+} // namespace rsg
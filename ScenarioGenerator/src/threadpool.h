@@ -0,0 +1,73 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rsg {
+
+// Fixed set of worker threads that run batches of independent tasks
+class ThreadPool
+{
+public:
+    // Creates pool that runs tasks using specified number of threads, including the calling one
+    explicit ThreadPool(std::size_t threadsTotal);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t getThreadsTotal() const
+    {
+        return workers.size() + 1;
+    }
+
+    // Calls task with each index in [0 : tasksTotal) and waits until all calls are finished.
+    // Calling thread runs tasks too. Tasks are taken in order of their indices,
+    // but can finish in any order.
+    // If tasks throw, exception of the task with the smallest index is rethrown
+    void run(std::size_t tasksTotal, const std::function<void(std::size_t)>& task);
+
+private:
+    void work();
+    // Runs tasks of current batch until there are no tasks left to take
+    void runTasks(std::unique_lock<std::mutex>& lock);
+
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable batchStarted;
+    std::condition_variable batchFinished;
+    const std::function<void(std::size_t)>* currentTask{};
+    std::vector<std::exception_ptr> errors;
+    std::size_t tasksTotal{};
+    std::size_t nextTask{};
+    std::size_t tasksLeft{};
+    std::size_t batch{};
+    bool stopping{};
+};
+
+} // namespace rsg
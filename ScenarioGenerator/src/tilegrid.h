@@ -0,0 +1,402 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "enums.h"
+#include "position.h"
+#include "tileinfo.h"
+#include "zoneid.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace rsg {
+
+// Generator tile states stored as separate planes.
+// Map is surrounded by one tile wide sentinel border,
+// so direct and diagonal neighbors of any map tile can be accessed without bounds checks.
+// Sentinel tiles are never free, possible, blocked or used, have no road
+// and belong to no zone.
+// Accessors taking tile index are unchecked, index must be obtained from toIndex().
+// Tiles of different zones can be changed from different threads at the same time.
+class TileGrid
+{
+public:
+    static constexpr TemplateZoneId noZone{-1};
+
+    void resize(int mapSize)
+    {
+        size = mapSize;
+        stride = mapSize + 2;
+
+        const auto total{static_cast<std::size_t>(stride) * stride};
+
+        occupied.assign(total, sentinelTile);
+        roads.assign(total, 0);
+        zoneIds.assign(total, noZone);
+        nearestObjectDistances.assign(total, maxDistance);
+        zonePossibleBits.clear();
+        changedTiles.clear();
+        trackedZones.clear();
+
+        for (int y = 0; y < size; ++y) {
+            for (int x = 0; x < size; ++x) {
+                occupied[toIndex(x, y)] = static_cast<std::uint8_t>(TileType::Possible);
+            }
+        }
+
+        computeOffsets(neighborOffsets, Position::getDirections());
+        computeOffsets(directNeighborOffsets, Position::getDirectDirections());
+        computeOffsets(diagonalNeighborOffsets, Position::getDiagonalDirections());
+    }
+
+    int getSize() const
+    {
+        return size;
+    }
+
+    // Returns distance between indices of vertically adjacent tiles
+    int getStride() const
+    {
+        return stride;
+    }
+
+    // Returns total number of tiles, including sentinel border
+    std::size_t getTotalTiles() const
+    {
+        return occupied.size();
+    }
+
+    std::size_t toIndex(int x, int y) const
+    {
+        return static_cast<std::size_t>(x + 1) + static_cast<std::size_t>(y + 1) * stride;
+    }
+
+    std::size_t toIndex(const Position& position) const
+    {
+        return toIndex(position.x, position.y);
+    }
+
+    Position toPosition(std::size_t index) const
+    {
+        return Position{static_cast<int>(index % stride) - 1,
+                        static_cast<int>(index / stride) - 1};
+    }
+
+    // Returns offsets from tile index to indices of its neighbors,
+    // in the same order as Position::getDirections()
+    const std::array<std::ptrdiff_t, 8>& getNeighborOffsets() const
+    {
+        return neighborOffsets;
+    }
+
+    // Returns offsets to direct neighbors, in Position::getDirectDirections() order
+    const std::array<std::ptrdiff_t, 4>& getDirectNeighborOffsets() const
+    {
+        return directNeighborOffsets;
+    }
+
+    // Returns offsets to diagonal neighbors, in Position::getDiagonalDirections() order
+    const std::array<std::ptrdiff_t, 4>& getDiagonalNeighborOffsets() const
+    {
+        return diagonalNeighborOffsets;
+    }
+
+    // Calls f with index of each neighbor tile that is on the map.
+    // If f returns bool, iteration stops as soon as it returns true.
+    // Returns true if iteration was stopped early
+    template <typename F>
+    bool foreachNeighbor(std::size_t index, F&& f) const
+    {
+        return visitNeighbors(index, neighborOffsets, f);
+    }
+
+    template <typename F>
+    bool foreachDirectNeighbor(std::size_t index, F&& f) const
+    {
+        return visitNeighbors(index, directNeighborOffsets, f);
+    }
+
+    template <typename F>
+    bool foreachDiagonalNeighbor(std::size_t index, F&& f) const
+    {
+        return visitNeighbors(index, diagonalNeighborOffsets, f);
+    }
+
+    // Returns true if tile with specified index belongs to sentinel border
+    bool isSentinel(std::size_t index) const
+    {
+        return occupied[index] == sentinelTile;
+    }
+
+    TileType getTileType(std::size_t index) const
+    {
+        return static_cast<TileType>(occupied[index]);
+    }
+
+    bool isBlocked(std::size_t index) const
+    {
+        return occupied[index] == static_cast<std::uint8_t>(TileType::Blocked)
+               || occupied[index] == static_cast<std::uint8_t>(TileType::Used);
+    }
+
+    bool shouldBeBlocked(std::size_t index) const
+    {
+        return occupied[index] == static_cast<std::uint8_t>(TileType::Blocked);
+    }
+
+    bool isPossible(std::size_t index) const
+    {
+        return occupied[index] == static_cast<std::uint8_t>(TileType::Possible);
+    }
+
+    bool isFree(std::size_t index) const
+    {
+        return occupied[index] == static_cast<std::uint8_t>(TileType::Free);
+    }
+
+    bool isUsed(std::size_t index) const
+    {
+        return occupied[index] == static_cast<std::uint8_t>(TileType::Used);
+    }
+
+    bool isRoad(std::size_t index) const
+    {
+        return roads[index] != 0;
+    }
+
+    void setOccupied(std::size_t index, TileType value)
+    {
+        const auto type{static_cast<std::uint8_t>(value)};
+
+        if (zoneIds[index] != noZone) {
+            const auto zone{static_cast<std::size_t>(zoneIds[index])};
+            if (trackedZones[zone] && occupied[index] != type) {
+                changedTiles[zone].push_back(index);
+            }
+
+            setBit(zonePossibleBits[zone], index, value == TileType::Possible);
+        }
+
+        occupied[index] = type;
+    }
+
+    // Starts or stops recording indices of zone tiles which type was changed.
+    // Only one thread can change tiles of zone while they are recorded
+    void setTrackChanges(TemplateZoneId zoneId, bool value)
+    {
+        const auto zone{addZone(zoneId)};
+
+        trackedZones[zone] = value;
+        changedTiles[zone].clear();
+    }
+
+    // Returns indices of zone tiles which type was changed since last clear.
+    // Same tile can be recorded several times
+    const std::vector<std::size_t>& getChangedTiles(TemplateZoneId zoneId) const
+    {
+        return changedTiles[static_cast<std::size_t>(zoneId)];
+    }
+
+    void clearChangedTiles(TemplateZoneId zoneId)
+    {
+        changedTiles[static_cast<std::size_t>(zoneId)].clear();
+    }
+
+    void setRoad(std::size_t index, bool value)
+    {
+        roads[index] = value ? 1 : 0;
+    }
+
+    TemplateZoneId getZoneId(std::size_t index) const
+    {
+        return zoneIds[index];
+    }
+
+    void setZoneId(std::size_t index, TemplateZoneId zoneId)
+    {
+        if (zoneIds[index] != noZone) {
+            setBit(zonePossibleBits[zoneIds[index]], index, false);
+        }
+
+        zoneIds[index] = zoneId;
+
+        if (zoneId != noZone) {
+            setBit(zonePossibleBits[addZone(zoneId)], index, isPossible(index));
+        }
+    }
+
+    // Returns true if all tiles of rectangle with top-left corner at index
+    // are possible and belong to specified zone.
+    // Rectangle must be within the map
+    bool isAreaPossible(std::size_t index, const Position& size, TemplateZoneId zoneId) const
+    {
+        const auto zone{static_cast<std::size_t>(zoneId)};
+        if (zoneId == noZone || zone >= zonePossibleBits.size() || zonePossibleBits[zone].empty()) {
+            return size.x <= 0 || size.y <= 0;
+        }
+
+        const auto& zoneTiles{zonePossibleBits[zone]};
+
+        // Compare rectangle rows using whole words instead of checking tiles one by one
+        for (int y = 0; y < size.y; ++y) {
+            const auto row{index + static_cast<std::size_t>(y) * stride};
+
+            for (int x = 0; x < size.x; x += bitsPerWord) {
+                const auto count{std::min(size.x - x, bitsPerWord)};
+                const auto mask{count == bitsPerWord ? ~std::uint64_t{0}
+                                                     : (std::uint64_t{1} << count) - 1};
+
+                if (getBits(zoneTiles, row + x, count) != mask) {
+                    return false;
+                }
+            }
+        }
+
+        return true;
+    }
+
+    float getNearestObjectDistance(std::size_t index) const
+    {
+        return nearestObjectDistances[index];
+    }
+
+    void setNearestObjectDistance(std::size_t index, float value)
+    {
+        // Distance can not be negative
+        nearestObjectDistances[index] = std::max(.0f, value);
+    }
+
+    // Returns copy of tile state
+    TileInfo getTileInfo(std::size_t index) const
+    {
+        TileInfo info;
+        info.setOccupied(getTileType(index));
+        info.setRoad(isRoad(index));
+        info.setNearestObjectDistance(getNearestObjectDistance(index));
+
+        return info;
+    }
+
+private:
+    template <std::size_t N>
+    void computeOffsets(std::array<std::ptrdiff_t, N>& offsets,
+                        const std::array<Position, N>& directions)
+    {
+        for (std::size_t i = 0; i < N; ++i) {
+            offsets[i] = directions[i].x + directions[i].y * static_cast<std::ptrdiff_t>(stride);
+        }
+    }
+
+    template <std::size_t N, typename F>
+    bool visitNeighbors(std::size_t index,
+                        const std::array<std::ptrdiff_t, N>& offsets,
+                        F& f) const
+    {
+        for (const auto offset : offsets) {
+            const std::size_t neighbor{index + offset};
+            if (isSentinel(neighbor)) {
+                continue;
+            }
+
+            if constexpr (std::is_same_v<std::invoke_result_t<F&, std::size_t>, bool>) {
+                if (f(neighbor)) {
+                    return true;
+                }
+            } else {
+                f(neighbor);
+            }
+        }
+
+        return false;
+    }
+
+    using Bits = std::vector<std::atomic<std::uint64_t>>;
+
+    // Allocates per-zone data for zone with specified id, returns its index
+    std::size_t addZone(TemplateZoneId zoneId)
+    {
+        const auto zone{static_cast<std::size_t>(zoneId)};
+        if (zone >= zonePossibleBits.size()) {
+            zonePossibleBits.resize(zone + 1);
+            changedTiles.resize(zone + 1);
+            trackedZones.resize(zone + 1, 0);
+        }
+
+        if (zonePossibleBits[zone].empty()) {
+            // Extra word allows to read bits past the last tile without checks
+            zonePossibleBits[zone] = Bits(occupied.size() / bitsPerWord + 2);
+        }
+
+        return zone;
+    }
+
+    static void setBit(Bits& bits, std::size_t index, bool value)
+    {
+        // Word can be shared with tiles changed by other threads
+        const auto bit{std::uint64_t{1} << (index % bitsPerWord)};
+        if (value) {
+            bits[index / bitsPerWord].fetch_or(bit, std::memory_order_relaxed);
+        } else {
+            bits[index / bitsPerWord].fetch_and(~bit, std::memory_order_relaxed);
+        }
+    }
+
+    // Returns count bits starting from bit with specified index, count must not exceed word size
+    static std::uint64_t getBits(const Bits& bits, std::size_t index, int count)
+    {
+        const auto word{index / bitsPerWord};
+        const auto shift{static_cast<int>(index % bitsPerWord)};
+
+        auto result{bits[word].load(std::memory_order_relaxed) >> shift};
+        if (shift + count > bitsPerWord) {
+            result |= bits[word + 1].load(std::memory_order_relaxed) << (bitsPerWord - shift);
+        }
+
+        return result & (count == bitsPerWord ? ~std::uint64_t{0}
+                                              : (std::uint64_t{1} << count) - 1);
+    }
+
+    static constexpr int bitsPerWord{64};
+    static constexpr std::uint8_t sentinelTile{std::numeric_limits<std::uint8_t>::max()};
+    static constexpr float maxDistance{static_cast<float>(std::numeric_limits<int>::max())};
+
+    std::vector<std::uint8_t> occupied;
+    std::vector<std::uint8_t> roads;
+    std::vector<TemplateZoneId> zoneIds;
+    std::vector<float> nearestObjectDistances;
+    // Bit planes over tile indices with possible tiles of each zone
+    std::vector<Bits> zonePossibleBits;
+    // Changed tiles of each zone and whether they are recorded
+    std::vector<std::vector<std::size_t>> changedTiles;
+    std::vector<std::uint8_t> trackedZones;
+    std::array<std::ptrdiff_t, 8> neighborOffsets{};
+    std::array<std::ptrdiff_t, 4> directNeighborOffsets{};
+    std::array<std::ptrdiff_t, 4> diagonalNeighborOffsets{};
+    int size{};
+    int stride{};
+};
+
+} // namespace rsg
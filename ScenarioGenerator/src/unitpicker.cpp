@@ -22,18 +22,492 @@
 #include "gameinfo.h"
 #include "generatorsettings.h"
 #include "picker.h"
+#include <algorithm>
+#include <cassert>
 #include <iterator>
+#include <numeric>
 
 namespace rsg {
 
-UnitInfo* pickLeader(RandomGenerator& random, const UnitFilterList& filters)
+UnitInfo* pickUnit(const std::vector<UnitInfo*>& unitPool,
+                   RandomGenerator& random,
+                   const UnitFilterList& filters)
 {
-    return pick(getGameInfo()->getLeaders(), random, filters);
+    return pick(unitPool, random, filters);
 }
 
 UnitInfo* pickUnit(RandomGenerator& random, const UnitFilterList& filters)
 {
-    return pick(getGameInfo()->getSoldiers(), random, filters);
+    return pickUnit(getGameInfo()->getSoldiers(), random, filters);
+}
+
+// Returns index of unit placement class, it matches bit of the class in UnitClassFlags
+static std::size_t getUnitClassIndex(const UnitInfo* info)
+{
+    if (info->isBig()) {
+        return 2;
+    }
+
+    return info->getAttackReach() == ReachType::Adjacent ? 0 : 1;
+}
+
+UnitIndex::UnitIndex(const std::vector<UnitInfo*>& unitPool)
+{
+    std::vector<UnitInfo*> sortedPool{unitPool};
+    // Units of equal value keep pool order, so picks do not depend on sort implementation
+    std::stable_sort(sortedPool.begin(), sortedPool.end(),
+                     [](const UnitInfo* a, const UnitInfo* b) {
+                         return a->getValue() < b->getValue();
+                     });
+
+    for (UnitInfo* unit : sortedPool) {
+        const auto subrace{static_cast<std::size_t>(unit->getSubrace())};
+        assert(subrace < subracesTotal);
+
+        auto& unitsOfClass{unitsBySubrace[subrace][getUnitClassIndex(unit)]};
+        unitsOfClass.values.push_back(unit->getValue());
+        unitsOfClass.units.push_back(unit);
+    }
+}
+
+UnitInfo* UnitIndex::pick(const std::set<SubRaceType>& subraces,
+                          std::uint8_t unitClasses,
+                          float minValue,
+                          std::size_t maxValue,
+                          RandomGenerator& random) const
+{
+    // Ranges of suitable units in each group
+    struct Range
+    {
+        const UnitsOfClass* unitsOfClass;
+        std::size_t start;
+        std::size_t count;
+    };
+
+    std::array<Range, subracesTotal * unitClassesTotal> ranges;
+    std::size_t rangesTotal{};
+    std::size_t total{};
+
+    auto addRanges = [&](const UnitsOfSubrace& unitsOfSubrace) {
+        for (std::size_t i = 0; i < unitClassesTotal; ++i) {
+            if (!(unitClasses & (1 << i))) {
+                continue;
+            }
+
+            const auto& values{unitsOfSubrace[i].values};
+            // Same comparisons as value filters used: value < minValue || value > maxValue
+            const auto begin{std::lower_bound(values.begin(), values.end(), minValue,
+                                              [](int value, float min) {
+                                                  return static_cast<float>(value) < min;
+                                              })};
+            const auto end{std::upper_bound(begin, values.end(), maxValue,
+                                            [](std::size_t max, int value) {
+                                                return static_cast<std::size_t>(value) > max;
+                                            })};
+            if (begin == end) {
+                continue;
+            }
+
+            const auto start{static_cast<std::size_t>(begin - values.begin())};
+            const auto count{static_cast<std::size_t>(end - begin)};
+
+            ranges[rangesTotal++] = Range{&unitsOfSubrace[i], start, count};
+            total += count;
+        }
+    };
+
+    if (subraces.empty()) {
+        for (const auto& unitsOfSubrace : unitsBySubrace) {
+            addRanges(unitsOfSubrace);
+        }
+    } else {
+        for (const auto& subrace : subraces) {
+            addRanges(unitsBySubrace[static_cast<std::size_t>(subrace)]);
+        }
+    }
+
+    if (!total) {
+        // Constraints are too tight, nothing to pick
+        return nullptr;
+    }
+
+    std::size_t index{random.nextInteger(std::size_t{0}, total - 1)};
+    for (std::size_t i = 0; i < rangesTotal; ++i) {
+        const auto& range{ranges[i]};
+        if (index < range.count) {
+            return range.unitsOfClass->units[range.start + index];
+        }
+
+        index -= range.count;
+    }
+
+    return nullptr;
+}
+
+std::vector<UnitInfo*> UnitIndex::getUnits(const std::set<SubRaceType>& subraces) const
+{
+    std::vector<UnitInfo*> units;
+
+    auto addUnits = [&units](const UnitsOfSubrace& unitsOfSubrace) {
+        for (const auto& unitsOfClass : unitsOfSubrace) {
+            units.insert(units.end(), unitsOfClass.units.begin(), unitsOfClass.units.end());
+        }
+    };
+
+    if (subraces.empty()) {
+        for (const auto& unitsOfSubrace : unitsBySubrace) {
+            addUnits(unitsOfSubrace);
+        }
+    } else {
+        for (const auto& subrace : subraces) {
+            addUnits(unitsBySubrace[static_cast<std::size_t>(subrace)]);
+        }
+    }
+
+    return units;
+}
+
+// Returns index of leader placement class.
+// Big leaders take a whole row, supports and ranged leaders stand at back line
+static std::size_t getLeaderClassIndex(const UnitInfo* info)
+{
+    if (info->isBig()) {
+        return 2;
+    }
+
+    return isSupport(*info) || info->getAttackReach() != ReachType::Adjacent ? 1 : 0;
+}
+
+// Returns index of layout by number of soldiers of each placement class
+static std::size_t getLayoutIndex(const std::array<int, 3>& units)
+{
+    return static_cast<std::size_t>(units[0] + units[1] * 4 + units[2] * 16);
+}
+
+StackCompositions::StackCompositions(const std::vector<UnitInfo*>& leaderPool,
+                                     const std::vector<UnitInfo*>& soldierPool,
+                                     int maxValue)
+    : leaders{groupByValue(leaderPool, true)}
+    , soldiers{groupByValue(soldierPool, false)}
+{
+    // Stack can not be stronger than its strongest leader with strongest soldiers
+    int maxLeaderValue{};
+    for (const auto& group : leaders) {
+        maxLeaderValue = std::max(maxLeaderValue, group.value);
+    }
+
+    int maxSoldierValue{};
+    for (const auto& group : soldiers) {
+        maxSoldierValue = std::max(maxSoldierValue, group.value);
+    }
+
+    const int strongestStack{maxLeaderValue + maxSoldiers * maxSoldierValue};
+    maxStackValue = std::max(0, std::min(maxValue, strongestStack));
+
+    // Layouts are ordered by number of soldiers,
+    // so counts of smaller layouts are ready when larger ones need them
+    layoutIndices.fill(-1);
+    for (int total = 0; total <= maxSoldiers; ++total) {
+        for (int big = 0; big <= rowsTotal; ++big) {
+            for (int ranged = 0; ranged <= rowsTotal; ++ranged) {
+                const int melee{total - big - ranged};
+                if (melee < 0 || melee > rowsTotal) {
+                    continue;
+                }
+
+                const Layout layout{{melee, ranged, big}, total};
+                if (fitsLeader(layout, 0) || fitsLeader(layout, 1) || fitsLeader(layout, 2)) {
+                    layoutIndices[getLayoutIndex(layout.units)] = static_cast<int>(layouts.size());
+                    layouts.push_back(layout);
+                }
+            }
+        }
+    }
+
+    const auto stride{static_cast<std::size_t>(maxStackValue) + 1};
+    sequenceSums.resize(layouts.size() * stride);
+
+    // Number of soldier sequences of each layout with exact total value.
+    // Empty group is the only sequence without soldiers
+    sequenceSums[0] = 1;
+    for (std::size_t i = 1; i < layouts.size(); ++i) {
+        auto* counts{&sequenceSums[i * stride]};
+
+        for (const auto& group : soldiers) {
+            const auto unitClass{group.unitClass};
+            if (group.value > maxStackValue) {
+                break;
+            }
+
+            if (!layouts[i].units[unitClass]) {
+                continue;
+            }
+
+            // Sequences that end with unit of this group
+            auto previous{layouts[i].units};
+            --previous[unitClass];
+
+            // Smaller layout fits group whenever larger one does
+            const auto previousIndex{layoutIndices[getLayoutIndex(previous)]};
+            assert(previousIndex >= 0);
+
+            const auto* previousCounts{&sequenceSums[previousIndex * stride]};
+            const std::uint64_t unitsTotal{group.units.size()};
+
+            for (int value = group.value; value <= maxStackValue; ++value) {
+                counts[value] += unitsTotal * previousCounts[value - group.value];
+            }
+        }
+    }
+
+    // Turn counts into sums, so number of sequences in any value range is a single subtraction
+    for (std::size_t i = 0; i < layouts.size(); ++i) {
+        auto* sums{&sequenceSums[i * stride]};
+        std::partial_sum(sums, sums + stride, sums);
+    }
+}
+
+bool StackCompositions::pick(StackComposition& composition,
+                             int minValue,
+                             int maxValue,
+                             RandomGenerator& random) const
+{
+    maxValue = std::min(maxValue, maxStackValue);
+    if (minValue > maxValue || leaders.empty()) {
+        return false;
+    }
+
+    // Calls function with number of compositions for each leader group and soldiers layout,
+    // stops when function returns true
+    auto forEachChoice = [this, minValue, maxValue](auto&& function) {
+        for (const auto& leader : leaders) {
+            if (leader.value > maxValue) {
+                return;
+            }
+
+            for (std::size_t i = 0; i < layouts.size(); ++i) {
+                if (!fitsLeader(layouts[i], leader.unitClass)) {
+                    continue;
+                }
+
+                const std::uint64_t sequences{
+                    countSequences(i, minValue - leader.value, maxValue - leader.value)};
+                if (sequences && function(leader, i, leader.units.size() * sequences)) {
+                    return;
+                }
+            }
+        }
+    };
+
+    std::array<std::uint64_t, maxSoldiers + 1> compositionsTotal{};
+    forEachChoice([this, &compositionsTotal](const UnitsOfValue&, std::size_t layout,
+                                             std::uint64_t compositions) {
+        compositionsTotal[layouts[layout].total] += compositions;
+        return false;
+    });
+
+    std::vector<int> soldierNumbers;
+    for (int i = 0; i <= maxSoldiers; ++i) {
+        if (compositionsTotal[i]) {
+            soldierNumbers.push_back(i);
+        }
+    }
+
+    if (soldierNumbers.empty()) {
+        // No composition fits value range
+        return false;
+    }
+
+    const int soldiersTotal{*getRandomElement(soldierNumbers, random)};
+
+    // Single draw chooses leader and whole soldiers sequence among all compositions
+    std::uint64_t choice{
+        random.nextInteger(std::uint64_t{0}, compositionsTotal[soldiersTotal] - 1)};
+
+    const UnitsOfValue* leaderGroup{};
+    std::size_t layoutIndex{};
+    forEachChoice([this, soldiersTotal, &choice, &leaderGroup, &layoutIndex](
+                      const UnitsOfValue& leader, std::size_t layout, std::uint64_t compositions) {
+        if (layouts[layout].total != soldiersTotal) {
+            return false;
+        }
+
+        if (choice >= compositions) {
+            choice -= compositions;
+            return false;
+        }
+
+        leaderGroup = &leader;
+        layoutIndex = layout;
+        return true;
+    });
+
+    assert(leaderGroup);
+
+    // Each leader of the group has the same number of soldier sequences
+    const int minSoldiersValue{std::max(0, minValue - leaderGroup->value)};
+    const int maxSoldiersValue{maxValue - leaderGroup->value};
+    const std::uint64_t sequences{countSequences(layoutIndex, minSoldiersValue, maxSoldiersValue)};
+
+    composition.leader = leaderGroup->units[choice / sequences];
+    choice %= sequences;
+
+    // Find total value of soldiers that the sequence has
+    const auto stride{static_cast<std::size_t>(maxStackValue) + 1};
+    const auto* sums{&sequenceSums[layoutIndex * stride]};
+    const std::uint64_t skipped{minSoldiersValue > 0 ? sums[minSoldiersValue - 1] : 0};
+
+    const auto valueEnd{std::upper_bound(sums + minSoldiersValue, sums + maxSoldiersValue + 1,
+                                         skipped + choice)};
+    int value{static_cast<int>(valueEnd - sums)};
+    choice -= (value > 0 ? sums[value - 1] : 0) - skipped;
+
+    // Walk sequence back from its last soldier, each step is chosen by its number of sequences
+    std::vector<const UnitInfo*> groupSoldiers;
+    auto units{layouts[layoutIndex].units};
+
+    while (groupSoldiers.size() < static_cast<std::size_t>(soldiersTotal)) {
+        bool found{};
+
+        for (const auto& group : soldiers) {
+            if (group.value > value) {
+                break;
+            }
+
+            if (!units[group.unitClass]) {
+                continue;
+            }
+
+            auto previous{units};
+            --previous[group.unitClass];
+
+            const auto previousIndex{
+                static_cast<std::size_t>(layoutIndices[getLayoutIndex(previous)])};
+            const auto previousValue{value - group.value};
+            const std::uint64_t previousSequences{
+                countSequences(previousIndex, previousValue, previousValue)};
+
+            const std::uint64_t count{group.units.size() * previousSequences};
+            if (choice >= count) {
+                choice -= count;
+                continue;
+            }
+
+            groupSoldiers.push_back(group.units[choice / previousSequences]);
+            choice %= previousSequences;
+
+            units = previous;
+            value = previousValue;
+            found = true;
+            break;
+        }
+
+        if (!found) {
+            // Counts do not match the walk, give up instead of looping forever
+            assert(false);
+            return false;
+        }
+    }
+
+    // Place leader where stacks picked unit by unit have it
+    const auto leaderClass{leaderGroup->unitClass};
+    std::set<int> positions{0, 1, 2, 3, 4, 5};
+
+    composition.leaderPosition = leaderClass == 1 ? 3 : 2;
+    positions.erase(static_cast<int>(composition.leaderPosition));
+    if (leaderClass == 2) {
+        positions.erase(3);
+    }
+
+    composition.soldiers = GroupUnits{};
+
+    // Big soldiers first, they need whole rows. Layout fits, so remaining units always have place
+    std::stable_sort(groupSoldiers.begin(), groupSoldiers.end(),
+                     [](const UnitInfo* a, const UnitInfo* b) {
+                         return a->isBig() && !b->isBig();
+                     });
+
+    for (const UnitInfo* unit : groupSoldiers) {
+        std::vector<int> freePositions;
+        for (int position : positions) {
+            const bool frontline{position % 2 == 0};
+
+            if (unit->isBig()) {
+                if (frontline && positions.count(position + 1)) {
+                    freePositions.push_back(position);
+                }
+            } else if (frontline == (unit->getAttackReach() == ReachType::Adjacent)) {
+                freePositions.push_back(position);
+            }
+        }
+
+        assert(!freePositions.empty());
+        const int position{*getRandomElement(freePositions, random)};
+
+        positions.erase(position);
+        composition.soldiers[position] = unit;
+
+        if (unit->isBig()) {
+            positions.erase(position + 1);
+            composition.soldiers[position + 1] = unit;
+        }
+    }
+
+    return true;
+}
+
+std::vector<StackCompositions::UnitsOfValue> StackCompositions::groupByValue(
+    const std::vector<UnitInfo*>& units,
+    bool leaders)
+{
+    std::vector<UnitsOfValue> groups;
+
+    for (const UnitInfo* unit : units) {
+        const auto unitClass{leaders ? getLeaderClassIndex(unit) : getUnitClassIndex(unit)};
+        const auto value{unit->getValue()};
+
+        auto it{std::find_if(groups.begin(), groups.end(),
+                             [unitClass, value](const UnitsOfValue& group) {
+                                 return group.unitClass == unitClass && group.value == value;
+                             })};
+        if (it == groups.end()) {
+            it = groups.insert(groups.end(), UnitsOfValue{unitClass, value, {}});
+        }
+
+        it->units.push_back(unit);
+    }
+
+    // Groups are sorted by value, so loops over them stop at the first group that is too strong.
+    // Equal values keep pool order, so picks do not depend on sort implementation
+    std::stable_sort(groups.begin(), groups.end(),
+                     [](const UnitsOfValue& a, const UnitsOfValue& b) {
+                         return a.value < b.value;
+                     });
+
+    return groups;
+}
+
+bool StackCompositions::fitsLeader(const Layout& layout, std::size_t leaderClass)
+{
+    auto units{layout.units};
+    ++units[leaderClass];
+
+    // Big units take whole rows, small melee units stand at front line, ranged at back line
+    return units[2] + std::max(units[0], units[1]) <= rowsTotal;
+}
+
+std::uint64_t StackCompositions::countSequences(std::size_t layout,
+                                                int minValue,
+                                                int maxValue) const
+{
+    minValue = std::max(0, minValue);
+    maxValue = std::min(maxValue, maxStackValue);
+    if (minValue > maxValue) {
+        return 0;
+    }
+
+    const auto* sums{&sequenceSums[layout * (static_cast<std::size_t>(maxStackValue) + 1)]};
+    return sums[maxValue] - (minValue > 0 ? sums[minValue - 1] : 0);
 }
 
 bool noForbiddenUnit(const UnitInfo* info)
@@ -19,7 +19,13 @@
 
 #pragma once
 
+#include "enums.h"
+#include "gameinfo.h"
+#include <array>
+#include <cstdint>
 #include <functional>
+#include <set>
+#include <vector>
 
 namespace rsg {
 
@@ -31,12 +37,127 @@ class RandomGenerator;
 using UnitFilterFunc = std::function<bool(const UnitInfo*)>;
 using UnitFilterList = std::initializer_list<UnitFilterFunc>;
 
-// Picks random leader from list after applying filters
-UnitInfo* pickLeader(RandomGenerator& random, const UnitFilterList& filters);
+// Picks random unit from specified pool
+UnitInfo* pickUnit(const std::vector<UnitInfo*>& unitPool,
+                   RandomGenerator& random,
+                   const UnitFilterList& filters);
 
 // Picks random soldier from list after applying filters
 UnitInfo* pickUnit(RandomGenerator& random, const UnitFilterList& filters);
 
+// Unit placement classes in group, can be combined
+enum UnitClassFlags : std::uint8_t
+{
+    SmallMeleeUnits = 1,
+    SmallRangedUnits = 1 << 1,
+    BigUnits = 1 << 2,
+    AnyUnits = SmallMeleeUnits | SmallRangedUnits | BigUnits,
+};
+
+// Units grouped by subrace and placement class, each group sorted by value.
+// Picks random unit with value in range using binary searches and a single draw
+class UnitIndex
+{
+public:
+    UnitIndex() = default;
+    explicit UnitIndex(const std::vector<UnitInfo*>& unitPool);
+
+    // Picks random unit of specified classes with value in [minValue : maxValue] range.
+    // Empty subraces set allows units of any subrace.
+    // Returns nullptr if there are no such units
+    UnitInfo* pick(const std::set<SubRaceType>& subraces,
+                   std::uint8_t unitClasses,
+                   float minValue,
+                   std::size_t maxValue,
+                   RandomGenerator& random) const;
+
+    // Returns units of specified subraces, empty set allows units of any subrace
+    std::vector<UnitInfo*> getUnits(const std::set<SubRaceType>& subraces) const;
+
+private:
+    static constexpr std::size_t subracesTotal{static_cast<std::size_t>(SubRaceType::Elf) + 1};
+    static constexpr std::size_t unitClassesTotal{3};
+
+    // Values are stored separately from units, so binary search does not call getValue()
+    struct UnitsOfClass
+    {
+        std::vector<int> values;
+        std::vector<UnitInfo*> units;
+    };
+
+    using UnitsOfSubrace = std::array<UnitsOfClass, unitClassesTotal>;
+
+    std::array<UnitsOfSubrace, subracesTotal> unitsBySubrace;
+};
+
+// Stack leader and soldiers at their group positions
+struct StackComposition
+{
+    const UnitInfo* leader{};
+    std::size_t leaderPosition{2};
+    GroupUnits soldiers{};
+};
+
+// Counts of leader and soldier sequences for every group layout and total value.
+// Counts are computed once with a knapsack-like dynamic program over unit values,
+// then any number of stacks with total value in range are sampled from them
+class StackCompositions
+{
+public:
+    StackCompositions(const std::vector<UnitInfo*>& leaderPool,
+                      const std::vector<UnitInfo*>& soldierPool,
+                      int maxValue);
+
+    // Picks leader and soldiers with total value in [minValue : maxValue] range.
+    // Number of soldiers is chosen evenly among numbers that fit the range,
+    // then every leader with ordered sequence of that many soldiers is equally likely,
+    // as if soldiers were picked one by one.
+    // Returns false if there is no such composition
+    bool pick(StackComposition& composition,
+              int minValue,
+              int maxValue,
+              RandomGenerator& random) const;
+
+private:
+    static constexpr int rowsTotal{3};
+    static constexpr int maxSoldiers{5};
+
+    // Units of the same placement class and value are interchangeable for the counts
+    struct UnitsOfValue
+    {
+        std::size_t unitClass{};
+        int value{};
+        std::vector<const UnitInfo*> units;
+    };
+
+    // Numbers of soldiers of each placement class
+    struct Layout
+    {
+        std::array<int, 3> units{};
+        int total{};
+    };
+
+    static std::vector<UnitsOfValue> groupByValue(const std::vector<UnitInfo*>& units,
+                                                  bool leaders);
+
+    // Returns true if soldiers fit group together with leader of specified class
+    static bool fitsLeader(const Layout& layout, std::size_t leaderClass);
+
+    // Returns number of soldier sequences of layout with total value in [minValue : maxValue]
+    std::uint64_t countSequences(std::size_t layout, int minValue, int maxValue) const;
+
+    std::vector<UnitsOfValue> leaders;
+    std::vector<UnitsOfValue> soldiers;
+    std::vector<Layout> layouts;
+    // Index of layout by number of soldiers of each class, -1 for layouts that never fit
+    std::array<int, 4 * 4 * 4> layoutIndices{};
+    // For each layout, numbers of soldier sequences with total value up to each value.
+    // Sequences of at most five soldiers of any game unit pool fit 64 bits
+    std::vector<std::uint64_t> sequenceSums;
+    // Counts are known for values up to this one
+    int maxStackValue{};
+};
+
 // These below are predefined filters
 
 // Remove units that are forbidden in generator settings from pick
@@ -27,6 +27,27 @@
 
 namespace rsg {
 
+// Computes sine and cosine of angle in [0 : 2pi] range.
+// Results of std::sin and std::cos differ between standard libraries,
+// Taylor polynomials use only basic arithmetic and give the same values on all platforms
+static void sinCos(double angle, double& sine, double& cosine)
+{
+    // sin(x) = -sin(x - pi), cos(x) = -cos(x - pi), reduced angle is in [-pi : pi]
+    const double x{angle - M_PI};
+    const double x2{x * x};
+
+    double sinSum{0.0};
+    double cosSum{0.0};
+    // Terms up to x^19 and x^20 give error less than 1e-8 in the whole range
+    for (int n = 10; n >= 1; --n) {
+        sinSum = 1.0 - sinSum * x2 / ((2.0 * n) * (2.0 * n + 1.0));
+        cosSum = 1.0 - cosSum * x2 / ((2.0 * n - 1.0) * (2.0 * n));
+    }
+
+    sine = -x * sinSum;
+    cosine = -cosSum;
+}
+
 void ZonePlacer::placeZones(RandomGenerator* random)
 {
     // TODO: Looks like this could help:
@@ -248,8 +269,13 @@ void ZonePlacer::prepareZones(ZonesMap& zones, ZoneVector& zonesVector, RandomGe
         totalSize += static_cast<float>(zone.second->size * zone.second->size);
 
         const float angle{static_cast<float>(random->nextDouble(0, pi2))};
+        double sine{};
+        double cosine{};
+        sinCos(angle, sine, cosine);
+
         // Place zones around circle
-        const VPosition center{0.5f + std::sinf(angle) * radius, 0.5f + std::cosf(angle) * radius};
+        const VPosition center{0.5f + static_cast<float>(sine) * radius,
+                               0.5f + static_cast<float>(cosine) * radius};
         zone.second->setCenter(center);
 
         if (mapGenerator->isDebugMode()) {
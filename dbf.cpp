@@ -18,11 +18,62 @@
  */
 
 #include "dbf.h"
-#include <charconv>
 #include <fstream>
+#include <limits>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <Windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 namespace rsg {
 
+// Parses fixed-width numeric field: leading spaces, optional minus sign and digits.
+// Stops at the first non-digit character, fails if there are no digits or value overflows
+static bool parseNumber(const char* first, std::size_t length, int& result)
+{
+    const char* last = first + length;
+    // skip spaces at the start of the field
+    while (first != last && *first == ' ') {
+        ++first;
+    }
+
+    const bool negative = first != last && *first == '-';
+    if (negative) {
+        ++first;
+    }
+
+    const std::int64_t limit = negative
+                                   ? -static_cast<std::int64_t>(std::numeric_limits<int>::min())
+                                   : std::numeric_limits<int>::max();
+    std::int64_t value{};
+    const char* digits = first;
+    for (; first != last; ++first) {
+        const unsigned int digit = static_cast<unsigned char>(*first) - '0';
+        if (digit > 9) {
+            break;
+        }
+
+        value = value * 10 + digit;
+        if (value > limit) {
+            return false;
+        }
+    }
+
+    if (first == digits) {
+        return false;
+    }
+
+    result = static_cast<int>(negative ? -value : value);
+    return true;
+}
+
 bool Dbf::Record::value(std::string_view& result, std::uint32_t columnIndex) const
 {
     if (!dbf) {
@@ -107,26 +158,7 @@ bool Dbf::Record::value(int& result, const Column& column) const
 
     // + 1 to skip 'deleted' flag
     const char* first = reinterpret_cast<const char*>(&data[column.dataAddress + 1]);
-    auto length = column.length;
-    // skip spaces at the start of the field to std::from_chars work properly
-    while (*first == ' ' && length) {
-        first++;
-        length--;
-    }
-
-    if (!length) {
-        return false;
-    }
-
-    const char* last = first + length;
-    int tmpResult{};
-    auto [p, ec] = std::from_chars(first, last, tmpResult);
-    if (ec != std::errc()) {
-        return false;
-    }
-
-    result = tmpResult;
-    return true;
+    return parseNumber(first, column.length, result);
 }
 
 bool Dbf::Record::value(bool& result, std::uint32_t columnIndex) const
@@ -172,9 +204,18 @@ bool Dbf::Record::value(bool& result, const Column& column) const
     return true;
 }
 
-Dbf::Dbf(const std::filesystem::path& filePath)
+Dbf::Dbf(const std::filesystem::path& filePath, Mode mode)
     : dbfFilePath{filePath}
 {
+    if (mode == Mode::Mapped) {
+        if (!mappedFile.open(filePath)) {
+            return;
+        }
+
+        valid = read(mappedFile.data(), mappedFile.size());
+        return;
+    }
+
     std::ifstream stream(filePath, std::ios_base::binary);
     if (!stream) {
         return;
@@ -184,49 +225,16 @@ Dbf::Dbf(const std::filesystem::path& filePath)
     const auto fileSize = stream.tellg();
     stream.seekg(0, stream.beg);
 
-    if (fileSize < sizeof(Header)) {
+    if (fileSize < 0) {
         return;
     }
 
-    if (!readHeader(stream)) {
+    fileData.resize(static_cast<std::size_t>(fileSize));
+    if (!stream.read(reinterpret_cast<char*>(fileData.data()), fileData.size())) {
         return;
     }
 
-    const auto recordsDataLength = recordsTotal() * header.recordLength;
-    const auto recordsEnd = header.headerLength + recordsDataLength;
-    if (recordsEnd + 1 != fileSize) {
-        return;
-    }
-
-    if (!readColumns(stream)) {
-        return;
-    }
-
-    char endOfFields{};
-    stream.read(&endOfFields, 1);
-
-    if (endOfFields != 0xd) {
-        return;
-    }
-
-    recordsData.resize(recordsDataLength);
-
-    // https://en.wikipedia.org/wiki/.dbf#Database_records
-    // Each record begins with a 1-byte "deletion" flag. The byte's value is a space (0x20), if the
-    // record is active, or an asterisk (0x2A), if the record is deleted.
-    char firstChar{};
-    stream.read(&firstChar, 1);
-    if (firstChar != ' ' && firstChar != '*') {
-        // Workaround for different file formats from Sdbf/SergDBF where there is an additional
-        // EOF/NUL between header and data blocks
-        stream.read(reinterpret_cast<char*>(&recordsData[0]), recordsDataLength);
-    } else {
-        recordsData[0] = firstChar;
-        stream.read(reinterpret_cast<char*>(&recordsData[1]), recordsDataLength - 1);
-    }
-
-    valid = true;
-    return;
+    valid = read(fileData.data(), fileData.size());
 }
 
 std::uint32_t Dbf::columnsTotal() const
@@ -260,21 +268,78 @@ bool Dbf::record(Record& result, std::uint32_t index) const
         return false;
     }
 
-    const auto* bgn = &recordsData[index * header.recordLength];
+    const auto* bgn = records + index * header.recordLength;
     result = Record(this, Record::Data(bgn, header.recordLength));
     return true;
 }
 
-bool Dbf::readHeader(std::ifstream& stream)
+bool Dbf::bindColumns(std::initializer_list<ColumnBinding> bindings) const
+{
+    bool result{true};
+    for (const auto& binding : bindings) {
+        binding.column = column(binding.name);
+        if (!binding.column) {
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+bool Dbf::read(const std::uint8_t* data, std::size_t size)
+{
+    if (size < sizeof(Header)) {
+        return false;
+    }
+
+    if (!readHeader(data, size)) {
+        return false;
+    }
+
+    const std::size_t recordsDataLength = static_cast<std::size_t>(recordsTotal())
+                                          * header.recordLength;
+    const std::size_t recordsEnd = header.headerLength + recordsDataLength;
+    if (recordsEnd + 1 != size) {
+        return false;
+    }
+
+    if (!readColumns(data)) {
+        return false;
+    }
+
+    std::size_t offset = sizeof(Header) + columns.size() * sizeof(Column);
+    if (data[offset++] != 0xd) {
+        return false;
+    }
+
+    // https://en.wikipedia.org/wiki/.dbf#Database_records
+    // Each record begins with a 1-byte "deletion" flag. The byte's value is a space (0x20), if the
+    // record is active, or an asterisk (0x2A), if the record is deleted.
+    if (recordsDataLength && data[offset] != ' ' && data[offset] != '*') {
+        // Workaround for different file formats from Sdbf/SergDBF where there is an additional
+        // EOF/NUL between header and data blocks
+        ++offset;
+    }
+
+    if (offset + recordsDataLength > size) {
+        return false;
+    }
+
+    records = data + offset;
+    return true;
+}
+
+bool Dbf::readHeader(const std::uint8_t* data, std::size_t size)
 {
     Header tmpHeader;
-    stream.read(reinterpret_cast<char*>(&tmpHeader), sizeof(tmpHeader));
+    std::memcpy(&tmpHeader, data, sizeof(tmpHeader));
 
     if (tmpHeader.version.parts.version != 0x3) {
         return false;
     }
 
-    if (tmpHeader.headerLength == 0 || tmpHeader.headerLength < sizeof(Header) + 1) {
+    if (tmpHeader.headerLength == 0 || tmpHeader.headerLength < sizeof(Header) + 1
+        || tmpHeader.headerLength > size) {
         return false;
     }
 
@@ -286,7 +351,7 @@ bool Dbf::readHeader(std::ifstream& stream)
     return true;
 }
 
-bool Dbf::readColumns(std::ifstream& stream)
+bool Dbf::readColumns(const std::uint8_t* data)
 {
     const auto columnsTotal = (header.headerLength - sizeof(Header) - 1) / sizeof(Column);
     Columns tmpColumns(columnsTotal);
@@ -295,9 +360,9 @@ bool Dbf::readColumns(std::ifstream& stream)
     std::uint32_t index{0};
     std::uint32_t dataAddress{0};
     for (auto& column : tmpColumns) {
-        if (!readColumn(stream, column)) {
-            return false;
-        }
+        std::memcpy(&column, data + sizeof(Header) + index * sizeof(Column), sizeof(Column));
+        // Make sure column name is always terminated
+        column.name[sizeof(column.name) - 1] = 0;
 
         column.dataAddress = dataAddress;
         dataAddress += column.length;
@@ -309,10 +374,73 @@ bool Dbf::readColumns(std::ifstream& stream)
     return true;
 }
 
-bool Dbf::readColumn(std::ifstream& stream, Column& column)
+Dbf::MappedFile::~MappedFile()
+{
+    if (!view) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(view);
+#else
+    munmap(view, viewSize);
+#endif
+}
+
+bool Dbf::MappedFile::open(const std::filesystem::path& filePath)
 {
-    stream.read(reinterpret_cast<char*>(&column), sizeof(Column));
+#ifdef _WIN32
+    HANDLE file = CreateFileW(filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize{};
+    if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0) {
+        CloseHandle(file);
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    // Mapping keeps file opened, view keeps mapping alive
+    CloseHandle(file);
+    if (!mapping) {
+        return false;
+    }
+
+    view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) {
+        return false;
+    }
+
+    viewSize = static_cast<std::size_t>(fileSize.QuadPart);
+    return true;
+#else
+    const int file = ::open(filePath.c_str(), O_RDONLY);
+    if (file == -1) {
+        return false;
+    }
+
+    struct stat status{};
+    if (fstat(file, &status) == -1 || status.st_size == 0) {
+        close(file);
+        return false;
+    }
+
+    void* address = mmap(nullptr, static_cast<std::size_t>(status.st_size), PROT_READ,
+                         MAP_PRIVATE, file, 0);
+    // Mapping stays valid after file is closed
+    close(file);
+    if (address == MAP_FAILED) {
+        return false;
+    }
+
+    view = address;
+    viewSize = static_cast<std::size_t>(status.st_size);
     return true;
+#endif
 }
 
 } // namespace rsg
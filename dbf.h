@@ -20,8 +20,10 @@
 #pragma once
 
 #include <cstdint>
+#include <cstring>
 #include <filesystem>
 #include <gsl/span>
+#include <initializer_list>
 #include <iterator>
 #include <map>
 #include <optional>
@@ -33,6 +35,12 @@ namespace rsg {
 class Dbf
 {
 public:
+    enum class Mode
+    {
+        Read,  /**< Whole file is read into memory. */
+        Mapped /**< File is mapped into memory, records are accessed in place. */
+    };
+
     enum class CodePage : std::uint8_t
     {
         DosUsa = 1,          /**< Code page 437 */
@@ -80,6 +88,13 @@ public:
 
     static_assert(sizeof(Column) == 32, "Size of Column structure must be exactly 32 bytes");
 
+    /** Column handle to be resolved by name, see bindColumns(). */
+    struct ColumnBinding
+    {
+        const char* name;
+        const Column*& column;
+    };
+
     class Record
     {
     public:
@@ -137,7 +152,7 @@ public:
         value_type operator*() const
         {
             const auto length{dbf->header.recordLength};
-            const auto ptr = &dbf->recordsData[index * length];
+            const auto ptr = dbf->records + index * length;
 
             return value_type{dbf, Record::Data{ptr, length}};
         }
@@ -174,7 +189,10 @@ public:
         std::uint32_t index;
     };
 
-    Dbf(const std::filesystem::path& filePath);
+    Dbf(const std::filesystem::path& filePath, Mode mode = Mode::Read);
+
+    Dbf(const Dbf&) = delete;
+    Dbf& operator=(const Dbf&) = delete;
 
     operator bool() const
     {
@@ -190,6 +208,13 @@ public:
     /** Returns nullptr if column with specified name can not be found. */
     const Column* column(const char* name) const;
 
+    /**
+     * Resolves column handles by their names once per table,
+     * so record loops access values without searching columns.
+     * @returns false if any of the columns can not be found.
+     */
+    bool bindColumns(std::initializer_list<ColumnBinding> bindings) const;
+
     /**
      * Creates thin wrapper for record data access.
      * Created records must not outlive DbfFile object that created them.
@@ -272,17 +297,46 @@ private:
         }
     };
 
+    // Read-only view of a file mapped into memory
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        bool open(const std::filesystem::path& filePath);
+
+        const std::uint8_t* data() const
+        {
+            return static_cast<const std::uint8_t*>(view);
+        }
+
+        std::size_t size() const
+        {
+            return viewSize;
+        }
+
+    private:
+        void* view{};
+        std::size_t viewSize{};
+    };
+
     using Columns = std::vector<Column>;
     using ColumnIndexMap = std::map<const char*, std::uint32_t, CompareKeys>;
 
-    bool readHeader(std::ifstream& stream);
-    bool readColumns(std::ifstream& stream);
-    bool readColumn(std::ifstream& stream, Column& column);
+    bool read(const std::uint8_t* data, std::size_t size);
+    bool readHeader(const std::uint8_t* data, std::size_t size);
+    bool readColumns(const std::uint8_t* data);
 
     Header header{};
     Columns columns;
     ColumnIndexMap columnIndices;
-    std::vector<std::uint8_t> recordsData;
+    std::vector<std::uint8_t> fileData;
+    MappedFile mappedFile;
+    const std::uint8_t* records{};
     std::filesystem::path dbfFilePath;
     bool valid{};
 };
@@ -30,16 +30,18 @@
 // argv[1] - template file
 // argv[2] - path to game
 // argv[3] - path where save created map
+// argv[4] - optional path to game data snapshot
 int main(int argc, char* argv[])
 {
     using namespace rsg;
 
-    assert(argc == 4);
+    assert(argc == 4 || argc == 5);
 
     const std::filesystem::path gameFolder{argv[2]};
+    const std::filesystem::path snapshotPath{argc == 5 ? argv[4] : ""};
 
     try {
-        const StandaloneGameInfo info(gameFolder);
+        const StandaloneGameInfo info(gameFolder, snapshotPath);
         setGameInfo(&info);
 
 #if 1
@@ -122,10 +124,10 @@ int main(int argc, char* argv[])
 
                     const std::size_t index = i + width * j;
 
-                    const auto zoneId{generator.zoneColoring[generator.posToIndex(pos)]};
+                    const auto zoneId{generator.getZoneId(pos)};
                     pixels[index] = colors[zoneId];
 
-                    auto& tile{generator.tiles[generator.posToIndex(pos)]};
+                    const auto tile{generator.getTile(pos)};
 
                     if (tile.isRoad()) {
                         pixels2[index] = RgbColor(175, 175, 175); // grey
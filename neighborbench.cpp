@@ -0,0 +1,147 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "tilegrid.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+
+// Measures cost of a path search expansion: visiting all neighbors of a tile
+// and checking whether they are free.
+// Compares neighbor iteration through std::function, as MapGenerator had it before,
+// with templated iteration over positions and over precomputed tile index offsets.
+// Build in Release, numbers of Debug builds say nothing
+
+namespace {
+
+using namespace rsg;
+
+constexpr int mapSize{144};
+constexpr int passes{200};
+
+// Previous MapGenerator::foreachNeighbor, it was defined in translation unit
+// and callers paid for type erasure on every expansion
+void foreachNeighborFunction(const TileGrid& grid,
+                             const Position& position,
+                             std::function<void(Position&)> f)
+{
+    for (const auto& direction : Position::getDirections()) {
+        Position p{position + direction};
+
+        if (p.x >= 0 && p.x < grid.getSize() && p.y >= 0 && p.y < grid.getSize()) {
+            f(p);
+        }
+    }
+}
+
+// Current MapGenerator::foreachNeighbor, map bounds are checked for each position
+template <typename F>
+void foreachNeighborTemplate(const TileGrid& grid, const Position& position, F&& f)
+{
+    for (const auto& direction : Position::getDirections()) {
+        Position p{position + direction};
+
+        if (p.x >= 0 && p.x < grid.getSize() && p.y >= 0 && p.y < grid.getSize()) {
+            f(p);
+        }
+    }
+}
+
+// Runs expansion of every map tile several times,
+// returns nanoseconds per expansion and adds free neighbors found to total
+template <typename F>
+double measure(const char* name, std::uint64_t& total, F&& expand)
+{
+    const auto start{std::chrono::steady_clock::now()};
+
+    std::uint64_t freeNeighbors{};
+    for (int pass = 0; pass < passes; ++pass) {
+        for (int y = 0; y < mapSize; ++y) {
+            for (int x = 0; x < mapSize; ++x) {
+                freeNeighbors += expand(Position{x, y});
+            }
+        }
+    }
+
+    const auto end{std::chrono::steady_clock::now()};
+    const std::chrono::duration<double, std::nano> elapsed{end - start};
+    const double expansions{static_cast<double>(passes) * mapSize * mapSize};
+    const double cost{elapsed.count() / expansions};
+
+    std::cout << name << ": " << cost << " ns per expansion\n";
+    total += freeNeighbors;
+    return cost;
+}
+
+} // namespace
+
+int main()
+{
+    TileGrid grid;
+    grid.resize(mapSize);
+
+    // Fixed pattern of free tiles, so visitors do some work and branches are not trivial
+    for (int y = 0; y < mapSize; ++y) {
+        for (int x = 0; x < mapSize; ++x) {
+            if ((x * 7 + y * 13) % 5 == 0) {
+                grid.setOccupied(grid.toIndex(x, y), TileType::Free);
+            }
+        }
+    }
+
+    std::uint64_t functionTotal{};
+    const double function{measure("std::function", functionTotal, [&grid](const Position& tile) {
+        int freeNeighbors{};
+        foreachNeighborFunction(grid, tile, [&grid, &freeNeighbors](Position& p) {
+            freeNeighbors += grid.isFree(grid.toIndex(p)) ? 1 : 0;
+        });
+
+        return freeNeighbors;
+    })};
+
+    std::uint64_t templateTotal{};
+    measure("Template over positions", templateTotal, [&grid](const Position& tile) {
+        int freeNeighbors{};
+        foreachNeighborTemplate(grid, tile, [&grid, &freeNeighbors](Position& p) {
+            freeNeighbors += grid.isFree(grid.toIndex(p)) ? 1 : 0;
+        });
+
+        return freeNeighbors;
+    });
+
+    std::uint64_t offsetsTotal{};
+    const double offsets{
+        measure("Template over index offsets", offsetsTotal, [&grid](const Position& tile) {
+            int freeNeighbors{};
+            grid.foreachNeighbor(grid.toIndex(tile), [&grid, &freeNeighbors](std::size_t index) {
+                freeNeighbors += grid.isFree(index) ? 1 : 0;
+            });
+
+            return freeNeighbors;
+        })};
+
+    if (functionTotal != templateTotal || functionTotal != offsetsTotal) {
+        std::cerr << "Neighbor iterations visited different tiles\n";
+        return 1;
+    }
+
+    std::cout << "Index offsets are " << function / offsets << " times faster than std::function\n";
+    return 0;
+}
@@ -0,0 +1,118 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "randomgenerator.h"
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <vector>
+
+// Measures random draws per second.
+// Compares std::function around a new distribution for each draw, as RandomGenerator had it
+// before, with distributions applied to engines directly and with RandomGenerator draws.
+// Build in Release, numbers of Debug builds say nothing
+
+namespace {
+
+constexpr int drawsTotal{20'000'000};
+constexpr std::uint64_t seed{20230611u};
+
+// Calls draw() drawsTotal times and prints millions of draws per second.
+// Returns sum of drawn values, so draws can not be optimized away
+template <typename F>
+std::uint64_t measure(const char* name, F&& draw)
+{
+    const auto start{std::chrono::steady_clock::now()};
+
+    std::uint64_t sum{};
+    for (int i = 0; i < drawsTotal; ++i) {
+        sum += static_cast<std::uint64_t>(draw());
+    }
+
+    const auto end{std::chrono::steady_clock::now()};
+    const std::chrono::duration<double> elapsed{end - start};
+
+    std::cout << name << ": " << drawsTotal / elapsed.count() / 1e6 << " M draws per second\n";
+    return sum;
+}
+
+// Previous RandomGenerator::getInt64Range
+std::function<std::int64_t()> getInt64Range(std::mt19937& engine,
+                                            std::int64_t min,
+                                            std::int64_t max)
+{
+    using Distribution = std::uniform_int_distribution<std::int64_t>;
+
+    return std::bind(Distribution(min, max), std::ref(engine));
+}
+
+template <typename Engine>
+std::uint64_t measureEngine(const char* name)
+{
+    Engine engine{static_cast<typename Engine::result_type>(seed)};
+
+    return measure(name, [&engine]() {
+        return std::uniform_int_distribution<std::int64_t>(0, 99)(engine);
+    });
+}
+
+} // namespace
+
+int main()
+{
+    using namespace rsg;
+
+    std::uint64_t sum{};
+
+    // Bounded integer draws, the most common draw in generator
+    std::mt19937 bindEngine{static_cast<std::mt19937::result_type>(seed)};
+    sum += measure("std::function with std::mt19937", [&bindEngine]() {
+        return getInt64Range(bindEngine, 0, 99)();
+    });
+
+    sum += measureEngine<std::mt19937>("Distribution with std::mt19937");
+    sum += measureEngine<Pcg32>("Distribution with Pcg32");
+    sum += measureEngine<Xoshiro256StarStar>("Distribution with Xoshiro256StarStar");
+
+    RandomGenerator random{seed};
+    sum += measure("RandomGenerator::nextInteger", [&random]() {
+        return random.nextInteger(0, 99);
+    });
+
+    sum += measure("RandomGenerator::chance", [&random]() { return random.chance(40); });
+
+    // Per-tile masks are filled at once
+    std::vector<std::uint8_t> mask(drawsTotal);
+    const auto start{std::chrono::steady_clock::now()};
+    random.fillChances(mask.begin(), mask.end(), 40);
+    const std::chrono::duration<double> elapsed{std::chrono::steady_clock::now() - start};
+
+    std::cout << "RandomGenerator::fillChances: " << drawsTotal / elapsed.count() / 1e6
+              << " M draws per second\n";
+
+    for (auto value : mask) {
+        sum += value;
+    }
+
+    // Print sum, so compiler keeps all draws
+    std::cout << "Checksum " << sum << '\n';
+    return 0;
+}
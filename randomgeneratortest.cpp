@@ -0,0 +1,116 @@
+/*
+ * This file is part of the random scenario generator for Disciples 2.
+ * (https://github.com/VladimirMakeev/D2RSG)
+ * Copyright (C) 2023 Vladimir Makeev.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "randomgenerator.h"
+#include <cstdint>
+#include <iostream>
+#include <iterator>
+#include <vector>
+
+// Checks that random draws match golden sequences.
+// Same seed must give the same scenario on every platform and compiler,
+// so any difference here means generated scenarios changed.
+// Returns nonzero exit code if at least one sequence does not match
+
+namespace {
+
+int failures{};
+
+template <typename T>
+void check(const char* name, const std::vector<T>& actual, const std::vector<T>& expected)
+{
+    if (actual == expected) {
+        return;
+    }
+
+    ++failures;
+
+    std::cerr << name << " does not match, got:";
+    for (const auto& value : actual) {
+        std::cerr << ' ' << value;
+    }
+
+    std::cerr << '\n';
+}
+
+} // namespace
+
+int main()
+{
+    using namespace rsg;
+
+    constexpr std::uint64_t seed{20230611u};
+
+    RandomGenerator::Engine engine{seed};
+    std::vector<std::uint64_t> engineValues;
+    for (int i = 0; i < 4; ++i) {
+        engineValues.push_back(engine());
+    }
+
+    check<std::uint64_t>("Engine", engineValues,
+                         {0x8e6cf17bb1983162ull, 0xc9bf5448b548ac45ull, 0x0663e3c970b0a9a0ull,
+                          0x0cf3109fe9df13b1ull});
+
+    // All draws below come from one forked stream, in this order
+    const RandomGenerator root{seed};
+    auto rand{root.fork(7u)};
+
+    std::vector<int> integers;
+    for (int i = 0; i < 8; ++i) {
+        integers.push_back(rand.nextInteger(-50, 50));
+    }
+
+    check<int>("nextInteger", integers, {17, 38, -27, 16, 6, 48, 29, 27});
+
+    std::vector<double> doubles;
+    for (int i = 0; i < 4; ++i) {
+        doubles.push_back(rand.nextDouble(0., 10.));
+    }
+
+    check<double>("nextDouble", doubles,
+                  {0x1.2c8b118e399d3p+1, 0x1.35de0fe28dbb1p+2, 0x1.db96eaf0e8478p-1,
+                   0x1.450e06d8fd7f5p+2});
+
+    std::vector<int> chances;
+    for (int i = 0; i < 16; ++i) {
+        chances.push_back(rand.chance(40) ? 1 : 0);
+    }
+
+    check<int>("chance", chances, {0, 1, 0, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 1, 0, 0});
+
+    std::vector<int> shuffled{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    randomShuffle(shuffled, rand);
+
+    check<int>("randomShuffle", shuffled, {6, 0, 1, 7, 4, 3, 9, 2, 5, 8});
+
+    const std::vector<int> population{0, 1, 2, 3, 4, 5, 6, 7, 8, 9};
+    std::vector<int> sample;
+    randomSample(population.begin(), population.end(), std::back_inserter(sample), 4, rand);
+
+    check<int>("randomSample", sample, {2, 3, 4, 8});
+
+    check<std::size_t>("constrainedSum", constrainedSum(5, 100, rand), {27, 10, 7, 28, 28});
+
+    if (failures) {
+        return 1;
+    }
+
+    std::cout << "Random draws match golden sequences\n";
+    return 0;
+}
@@ -27,8 +27,14 @@
 #include "standalonespellinfo.h"
 #include "standaloneunitinfo.h"
 #include "textconvert.h"
+#include <array>
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <type_traits>
 
 namespace rsg {
 
@@ -40,7 +46,7 @@ static bool isVanillaReachId(int reachId)
            || reachId == (int)ReachType::Adjacent;
 }
 
-static bool readId(const Dbf::Record& record, const char* column, CMidgardID& id)
+static bool readId(const Dbf::Record& record, const Dbf::Column& column, CMidgardID& id)
 {
     std::string_view idString{};
     if (!record.value(idString, column)) {
@@ -62,15 +68,16 @@ static bool readTexts(TextsInfo& texts,
 {
     texts.clear();
 
-    Dbf db{folderPath / dbFileName};
+    Dbf db{folderPath / dbFileName, Dbf::Mode::Mapped};
     if (!db) {
         std::cerr << "Could not open " << dbFileName << '\n';
         return false;
     }
 
-    const Dbf::Column* textColumn{db.column("TEXT")};
-    if (!textColumn) {
-        std::cerr << "Missing 'TEXT' column in " << dbFileName << '\n';
+    const Dbf::Column* idColumn{};
+    const Dbf::Column* textColumn{};
+    if (!db.bindColumns({{"TXT_ID", idColumn}, {"TEXT", textColumn}})) {
+        std::cerr << "Missing columns in " << dbFileName << '\n';
         return false;
     }
 
@@ -82,12 +89,12 @@ static bool readTexts(TextsInfo& texts,
         }
 
         CMidgardID textId;
-        if (!readId(record, "TXT_ID", textId)) {
+        if (!readId(record, *idColumn, textId)) {
             continue;
         }
 
         std::string_view textView{};
-        if (!record.value(textView, "TEXT")) {
+        if (!record.value(textView, *textColumn)) {
             continue;
         }
 
@@ -103,14 +110,21 @@ static bool readSiteText(SiteTexts& texts,
 {
     texts.clear();
 
-    Dbf db{dbFilename};
+    Dbf db{dbFilename, Dbf::Mode::Mapped};
     if (!db) {
         std::cerr << "Could not open " << dbFilename.filename().string() << '\n';
         return false;
     }
 
-    const auto nameLength = db.column("NAME")->length;
-    const auto descriptionLength = db.column("DESC")->length;
+    const Dbf::Column* nameColumn{};
+    const Dbf::Column* descriptionColumn{};
+    if (!db.bindColumns({{"NAME", nameColumn}, {"DESC", descriptionColumn}})) {
+        std::cerr << "Missing columns in " << dbFilename.filename().string() << '\n';
+        return false;
+    }
+
+    const auto nameLength = nameColumn->length;
+    const auto descriptionLength = descriptionColumn->length;
 
     for (const auto& record : db) {
         if (record.deleted()) {
@@ -118,7 +132,7 @@ static bool readSiteText(SiteTexts& texts,
         }
 
         std::string_view nameView{};
-        if (!record.value(nameView, "NAME")) {
+        if (!record.value(nameView, *nameColumn)) {
             continue;
         }
 
@@ -127,7 +141,7 @@ static bool readSiteText(SiteTexts& texts,
 
         if (readDescriptions) {
             std::string_view descriptionView{};
-            if (record.value(descriptionView, "DESC")) {
+            if (record.value(descriptionView, *descriptionColumn)) {
                 text.description = translate(descriptionView, descriptionLength);
             }
         }
@@ -138,9 +152,290 @@ static bool readSiteText(SiteTexts& texts,
     return true;
 }
 
-StandaloneGameInfo::StandaloneGameInfo(const std::filesystem::path& gameFolderPath)
+// Snapshot file layout: header, key of source files and parsed data sections.
+// Snapshot is written and read by the same build, so raw values are stored as is
+static constexpr char snapshotMagic[4] = {'R', 'S', 'G', 'S'};
+static constexpr std::uint32_t snapshotVersion{1};
+static constexpr std::uint32_t snapshotByteOrder{0x01020304};
+static constexpr std::uint32_t snapshotEnd{0x21444e45};
+
+// Game files parsed by StandaloneGameInfo, relative to game folder
+static const char* const snapshotSources[] = {
+    "Globals/LAttR.dbf",
+    "Globals/GAttacks.dbf",
+    "Globals/GUnits.dbf",
+    "Globals/GItem.dbf",
+    "Globals/GSpells.dbf",
+    "Globals/GLmark.dbf",
+    "Globals/Grace.dbf",
+    "Globals/Tleader.dbf",
+    "Globals/Tglobal.dbf",
+    "Interf/TAppEdit.dbf",
+    "ScenData/Cityname.dbf",
+    "ScenData/Campname.dbf",
+    "ScenData/Magename.dbf",
+    "ScenData/Mercname.dbf",
+    "ScenData/Ruinname.dbf",
+    "ScenData/Trainame.dbf",
+};
+
+class SnapshotWriter
+{
+public:
+    template <typename T>
+    void write(const T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        const char* bytes{reinterpret_cast<const char*>(&value)};
+        data.insert(data.end(), bytes, bytes + sizeof(T));
+    }
+
+    void write(bool value)
+    {
+        write(static_cast<std::uint8_t>(value));
+    }
+
+    void write(const CMidgardID& id)
+    {
+        write(id.getValue());
+    }
+
+    void write(const std::string& string)
+    {
+        write(static_cast<std::uint32_t>(string.size()));
+        data.insert(data.end(), string.begin(), string.end());
+    }
+
+    void write(const std::vector<char>& bytes)
+    {
+        write(static_cast<std::uint32_t>(bytes.size()));
+        data.insert(data.end(), bytes.begin(), bytes.end());
+    }
+
+    template <typename T>
+    void writeEnum(T value)
+    {
+        write(static_cast<std::int32_t>(value));
+    }
+
+    void writeSize(std::size_t size)
+    {
+        write(static_cast<std::uint32_t>(size));
+    }
+
+    std::vector<char> data;
+};
+
+// Reads values written by SnapshotWriter, fails on truncated data
+class SnapshotReader
+{
+public:
+    SnapshotReader(const std::vector<char>& data)
+        : current{data.data()}
+        , end{data.data() + data.size()}
+    { }
+
+    template <typename T>
+    bool read(T& value)
+    {
+        static_assert(std::is_trivially_copyable_v<T>);
+
+        if (static_cast<std::size_t>(end - current) < sizeof(T)) {
+            return false;
+        }
+
+        std::memcpy(&value, current, sizeof(T));
+        current += sizeof(T);
+        return true;
+    }
+
+    bool read(bool& value)
+    {
+        std::uint8_t tmp{};
+        if (!read(tmp)) {
+            return false;
+        }
+
+        value = tmp != 0;
+        return true;
+    }
+
+    bool read(CMidgardID& id)
+    {
+        std::uint32_t value{};
+        if (!read(value)) {
+            return false;
+        }
+
+        id = CMidgardID{value};
+        return true;
+    }
+
+    bool read(std::string& string)
+    {
+        std::uint32_t size{};
+        if (!read(size) || static_cast<std::size_t>(end - current) < size) {
+            return false;
+        }
+
+        string.assign(current, size);
+        current += size;
+        return true;
+    }
+
+    bool read(std::vector<char>& bytes)
+    {
+        std::uint32_t size{};
+        if (!read(size) || static_cast<std::size_t>(end - current) < size) {
+            return false;
+        }
+
+        bytes.assign(current, current + size);
+        current += size;
+        return true;
+    }
+
+    template <typename T>
+    bool readEnum(T& value)
+    {
+        std::int32_t tmp{};
+        if (!read(tmp)) {
+            return false;
+        }
+
+        value = static_cast<T>(tmp);
+        return true;
+    }
+
+private:
+    const char* current;
+    const char* end;
+};
+
+// Snapshot key describes source files: their sizes and modification times.
+// Returns false if any of the files could not be found
+static bool createSnapshotKey(std::vector<char>& key, const std::filesystem::path& gameFolderPath)
+{
+    SnapshotWriter writer;
+
+    for (const char* source : snapshotSources) {
+        const std::filesystem::path sourcePath{gameFolderPath / source};
+
+        std::error_code error;
+        const auto size{std::filesystem::file_size(sourcePath, error)};
+        if (error) {
+            return false;
+        }
+
+        const auto time{std::filesystem::last_write_time(sourcePath, error)};
+        if (error) {
+            return false;
+        }
+
+        writer.write(std::string{source});
+        writer.write(static_cast<std::uint64_t>(size));
+        writer.write(static_cast<std::int64_t>(time.time_since_epoch().count()));
+    }
+
+    key = std::move(writer.data);
+    return true;
+}
+
+static void writeSnapshotTexts(SnapshotWriter& writer, const TextsInfo& texts)
+{
+    writer.writeSize(texts.size());
+    for (const auto& [textId, text] : texts) {
+        writer.write(textId);
+        writer.write(text);
+    }
+}
+
+static bool readSnapshotTexts(TextsInfo& texts, SnapshotReader& reader)
+{
+    texts.clear();
+
+    std::uint32_t count{};
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        CMidgardID textId;
+        std::string text;
+        if (!reader.read(textId) || !reader.read(text)) {
+            return false;
+        }
+
+        texts[textId] = std::move(text);
+    }
+
+    return true;
+}
+
+static void writeSnapshotStrings(SnapshotWriter& writer, const std::vector<std::string>& strings)
+{
+    writer.writeSize(strings.size());
+    for (const auto& string : strings) {
+        writer.write(string);
+    }
+}
+
+static bool readSnapshotStrings(std::vector<std::string>& strings, SnapshotReader& reader)
+{
+    strings.clear();
+
+    std::uint32_t count{};
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::string string;
+        if (!reader.read(string)) {
+            return false;
+        }
+
+        strings.push_back(std::move(string));
+    }
+
+    return true;
+}
+
+static void writeSnapshotSiteTexts(SnapshotWriter& writer, const SiteTexts& texts)
+{
+    writer.writeSize(texts.size());
+    for (const auto& text : texts) {
+        writer.write(text.name);
+        writer.write(text.description);
+    }
+}
+
+static bool readSnapshotSiteTexts(SiteTexts& texts, SnapshotReader& reader)
+{
+    texts.clear();
+
+    std::uint32_t count{};
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        SiteText text;
+        if (!reader.read(text.name) || !reader.read(text.description)) {
+            return false;
+        }
+
+        texts.emplace_back(std::move(text));
+    }
+
+    return true;
+}
+
+StandaloneGameInfo::StandaloneGameInfo(const std::filesystem::path& gameFolderPath,
+                                       const std::filesystem::path& snapshotPath)
 {
-    if (!readGameInfo(gameFolderPath)) {
+    if (!readGameInfo(gameFolderPath, snapshotPath)) {
         throw std::runtime_error("Could not read game info");
     }
 }
@@ -321,9 +616,10 @@ const char* StandaloneGameInfo::getText(const TextsInfo& texts, const CMidgardID
     return it->second.c_str();
 }
 
-bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolderPath)
+void StandaloneGameInfo::clearUnits()
 {
     unitsInfo.clear();
+    units.clear();
     leaders.clear();
     soldiers.clear();
 
@@ -332,12 +628,48 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
 
     minSoldierValue = std::numeric_limits<int>::max();
     maxSoldierValue = std::numeric_limits<int>::min();
+}
+
+void StandaloneGameInfo::addUnit(UnitInfoPtr&& info)
+{
+    const int value{info->getValue()};
+
+    if (info->getUnitType() == UnitType::Leader) {
+        leaders.push_back(info.get());
+
+        if (value < minLeaderValue) {
+            minLeaderValue = value;
+        }
+
+        if (value > maxLeaderValue) {
+            maxLeaderValue = value;
+        }
+
+    } else if (info->getUnitType() == UnitType::Soldier) {
+        soldiers.push_back(info.get());
+
+        if (value < minSoldierValue) {
+            minSoldierValue = value;
+        }
+
+        if (value > maxSoldierValue) {
+            maxSoldierValue = value;
+        }
+    }
+
+    units.push_back(info.get());
+    unitsInfo[info->getUnitId()] = std::move(info);
+}
+
+bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolderPath)
+{
+    clearUnits();
 
     bool customReaches{false};
     std::map<int /* raw reach id */, ReachType /* actual reach type to use instead */> reaches;
 
     {
-        Dbf reachDb{globalsFolderPath / "LAttR.dbf"};
+        Dbf reachDb{globalsFolderPath / "LAttR.dbf", Dbf::Mode::Mapped};
         if (!reachDb) {
             std::cerr << "Could not open LAttR.dbf\n";
             return false;
@@ -347,13 +679,23 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
         // Don't bother reading even vanilla ones if there are no custom reaches
         customReaches = reachDb.column("MELEE") != nullptr;
         if (customReaches) {
+            const Dbf::Column* idColumn{};
+            const Dbf::Column* meleeColumn{};
+            const Dbf::Column* maxTargetsColumn{};
+            if (!reachDb.bindColumns({{"ID", idColumn},
+                                      {"MELEE", meleeColumn},
+                                      {"MAX_TARGTS", maxTargetsColumn}})) {
+                std::cerr << "Missing columns in LAttR.dbf\n";
+                return false;
+            }
+
             for (const auto& record : reachDb) {
                 if (record.deleted()) {
                     continue;
                 }
 
                 int rawId{};
-                if (!record.value(rawId, "ID")) {
+                if (!record.value(rawId, *idColumn)) {
                     continue;
                 }
 
@@ -364,7 +706,7 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
                     // depending on 'melee' hint and max targets count.
                     // We don't care about their actual logic
                     bool melee{false};
-                    if (!record.value(melee, "MELEE")) {
+                    if (!record.value(melee, *meleeColumn)) {
                         continue;
                     }
 
@@ -374,7 +716,7 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
                         // Non-melee custom reaches with 6 max targets becomes 'All',
                         // others are 'Any'
                         int maxTargets{};
-                        if (!record.value(maxTargets, "MAX_TARGTS")) {
+                        if (!record.value(maxTargets, *maxTargetsColumn)) {
                             continue;
                         }
 
@@ -390,19 +732,28 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
     std::map<CMidgardID /* attack id */, std::pair<ReachType, AttackType>> attacks;
 
     {
-        Dbf attacksDb{globalsFolderPath / "GAttacks.dbf"};
+        Dbf attacksDb{globalsFolderPath / "GAttacks.dbf", Dbf::Mode::Mapped};
         if (!attacksDb) {
             std::cerr << "Could not open GAttacks.dbf\n";
             return false;
         }
 
+        const Dbf::Column* idColumn{};
+        const Dbf::Column* reachColumn{};
+        const Dbf::Column* classColumn{};
+        if (!attacksDb.bindColumns(
+                {{"ATT_ID", idColumn}, {"REACH", reachColumn}, {"CLASS", classColumn}})) {
+            std::cerr << "Missing columns in GAttacks.dbf\n";
+            return false;
+        }
+
         for (const auto& record : attacksDb) {
             if (record.deleted()) {
                 continue;
             }
 
             std::string_view idString{};
-            if (!record.value(idString, "ATT_ID")) {
+            if (!record.value(idString, *idColumn)) {
                 continue;
             }
 
@@ -412,12 +763,12 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
             }
 
             int reach{};
-            if (!record.value(reach, "REACH")) {
+            if (!record.value(reach, *reachColumn)) {
                 continue;
             }
 
             int type{};
-            if (!record.value(type, "CLASS")) {
+            if (!record.value(type, *classColumn)) {
                 continue;
             }
 
@@ -437,19 +788,51 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
         }
     }
 
-    Dbf unitsDb{globalsFolderPath / "GUnits.dbf"};
+    Dbf unitsDb{globalsFolderPath / "GUnits.dbf", Dbf::Mode::Mapped};
     if (!unitsDb) {
         std::cerr << "Could not open GUnits.dbf\n";
         return false;
     }
 
+    const Dbf::Column* waterOnlyColumn{};
+    const Dbf::Column* idColumn{};
+    const Dbf::Column* typeColumn{};
+    const Dbf::Column* levelColumn{};
+    const Dbf::Column* raceIdColumn{};
+    const Dbf::Column* smallColumn{};
+    const Dbf::Column* maleColumn{};
+    const Dbf::Column* subraceColumn{};
+    const Dbf::Column* nameIdColumn{};
+    const Dbf::Column* attackIdColumn{};
+    const Dbf::Column* hpColumn{};
+    const Dbf::Column* moveColumn{};
+    const Dbf::Column* leadershipColumn{};
+    const Dbf::Column* valueColumn{};
+    if (!unitsDb.bindColumns({{"WATER_ONLY", waterOnlyColumn},
+                              {"UNIT_ID", idColumn},
+                              {"UNIT_CAT", typeColumn},
+                              {"LEVEL", levelColumn},
+                              {"RACE_ID", raceIdColumn},
+                              {"SIZE_SMALL", smallColumn},
+                              {"SEX_M", maleColumn},
+                              {"SUBRACE", subraceColumn},
+                              {"NAME_TXT", nameIdColumn},
+                              {"ATTACK_ID", attackIdColumn},
+                              {"HIT_POINT", hpColumn},
+                              {"MOVE", moveColumn},
+                              {"LEADERSHIP", leadershipColumn},
+                              {"XP_KILLED", valueColumn}})) {
+        std::cerr << "Missing columns in GUnits.dbf\n";
+        return false;
+    }
+
     for (const auto& record : unitsDb) {
         if (record.deleted()) {
             continue;
         }
 
         bool waterOnly{};
-        if (!record.value(waterOnly, "WATER_ONLY")) {
+        if (!record.value(waterOnly, *waterOnlyColumn)) {
             continue;
         }
 
@@ -459,7 +842,7 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
         }
 
         std::string_view idString{};
-        if (!record.value(idString, "UNIT_ID")) {
+        if (!record.value(idString, *idColumn)) {
             continue;
         }
 
@@ -469,19 +852,19 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
         }
 
         int type{};
-        if (!record.value(type, "UNIT_CAT")) {
+        if (!record.value(type, *typeColumn)) {
             continue;
         }
 
         const auto unitType{static_cast<UnitType>(type)};
 
         int level{};
-        if (!record.value(level, "LEVEL")) {
+        if (!record.value(level, *levelColumn)) {
             continue;
         }
 
         std::string_view raceIdString{};
-        if (!record.value(raceIdString, "RACE_ID")) {
+        if (!record.value(raceIdString, *raceIdColumn)) {
             continue;
         }
 
@@ -491,22 +874,22 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
         }
 
         bool smallUnit{};
-        if (!record.value(smallUnit, "SIZE_SMALL")) {
+        if (!record.value(smallUnit, *smallColumn)) {
             continue;
         }
 
         bool male{};
-        if (!record.value(male, "SEX_M")) {
+        if (!record.value(male, *maleColumn)) {
             continue;
         }
 
         int subrace{};
-        if (!record.value(subrace, "SUBRACE")) {
+        if (!record.value(subrace, *subraceColumn)) {
             continue;
         }
 
         std::string_view nameIdString{};
-        if (!record.value(nameIdString, "NAME_TXT")) {
+        if (!record.value(nameIdString, *nameIdColumn)) {
             continue;
         }
 
@@ -517,7 +900,7 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
 
         // We only interested in primary attack
         std::string_view attackString{};
-        if (!record.value(attackString, "ATTACK_ID")) {
+        if (!record.value(attackString, *attackIdColumn)) {
             continue;
         }
 
@@ -534,24 +917,24 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
         }
 
         int hp{};
-        if (!record.value(hp, "HIT_POINT")) {
+        if (!record.value(hp, *hpColumn)) {
             continue;
         }
 
         int move{};
         int leadership{};
         if (unitType == UnitType::Leader) {
-            if (!record.value(move, "MOVE")) {
+            if (!record.value(move, *moveColumn)) {
                 continue;
             }
 
-            if (!record.value(leadership, "LEADERSHIP")) {
+            if (!record.value(leadership, *leadershipColumn)) {
                 continue;
             }
         }
 
         int value{};
-        if (!record.value(value, "XP_KILLED")) {
+        if (!record.value(value, *valueColumn)) {
             continue;
         }
 
@@ -561,69 +944,66 @@ bool StandaloneGameInfo::readUnitsInfo(const std::filesystem::path& globalsFolde
 
         auto& pair{it->second};
 
-        auto info{std::make_unique<StandaloneUnitInfo>(unitId, raceId, nameId, level, value,
-                                                       unitType, static_cast<SubRaceType>(subrace),
-                                                       pair.first, pair.second, hp, move,
-                                                       leadership, !smallUnit, male)};
-
-        if (unitType == UnitType::Leader) {
-            leaders.push_back(info.get());
-
-            if (value < minLeaderValue) {
-                minLeaderValue = value;
-            }
-
-            if (value > maxLeaderValue) {
-                maxLeaderValue = value;
-            }
-
-        } else if (unitType == UnitType::Soldier) {
-            soldiers.push_back(info.get());
-
-            if (value < minSoldierValue) {
-                minSoldierValue = value;
-            }
-
-            if (value > maxSoldierValue) {
-                maxSoldierValue = value;
-            }
-        }
-
-        unitsInfo[unitId] = std::move(info);
+        addUnit(std::make_unique<StandaloneUnitInfo>(unitId, raceId, nameId, level, value,
+                                                     unitType, static_cast<SubRaceType>(subrace),
+                                                     pair.first, pair.second, hp, move,
+                                                     leadership, !smallUnit, male));
     }
 
     return true;
 }
 
-bool StandaloneGameInfo::readItemsInfo(const std::filesystem::path& globalsFolderPath)
+void StandaloneGameInfo::clearItems()
 {
     itemsInfo.clear();
     allItems.clear();
     itemsByType.clear();
+}
+
+void StandaloneGameInfo::addItem(ItemInfoPtr&& info)
+{
+    allItems.push_back(info.get());
+    itemsByType[info->getItemType()].push_back(info.get());
+    itemsInfo[info->getItemId()] = std::move(info);
+}
+
+bool StandaloneGameInfo::readItemsInfo(const std::filesystem::path& globalsFolderPath)
+{
+    clearItems();
 
-    Dbf itemsDb{globalsFolderPath / "GItem.dbf"};
+    Dbf itemsDb{globalsFolderPath / "GItem.dbf", Dbf::Mode::Mapped};
     if (!itemsDb) {
         std::cerr << "Could not open GItem.dbf\n";
         return false;
     }
 
+    const Dbf::Column* typeColumn{};
+    const Dbf::Column* idColumn{};
+    const Dbf::Column* valueColumn{};
+    if (!itemsDb.bindColumns({{"ITEM_CAT", typeColumn},
+                              {"ITEM_ID", idColumn},
+                              {"VALUE", valueColumn}})) {
+        std::cerr << "Missing columns in GItem.dbf\n";
+        return false;
+    }
+
     for (const auto& record : itemsDb) {
         if (record.deleted()) {
             continue;
         }
 
         int type{};
-        if (!record.value(type, "ITEM_CAT")) {
+        if (!record.value(type, *typeColumn)) {
             continue;
         }
 
         CMidgardID itemId;
-        if (!readId(record, "ITEM_ID", itemId)) {
+        if (!readId(record, *idColumn, itemId)) {
             continue;
         }
 
         std::string_view valueString{};
-        if (!record.value(valueString, "VALUE")) {
+        if (!record.value(valueString, *valueColumn)) {
             continue;
         }
 
@@ -643,50 +1023,70 @@ bool StandaloneGameInfo::readItemsInfo(const std::filesystem::path& globalsFolde
             value *= 5;
         }
 
-        auto info{std::make_unique<StandaloneItemInfo>(itemId, value, itemType)};
-
-        allItems.push_back(info.get());
-        itemsByType[itemType].push_back(info.get());
-        itemsInfo[itemId] = std::move(info);
+        addItem(std::make_unique<StandaloneItemInfo>(itemId, value, itemType));
     }
 
     return true;
 }
 
-bool StandaloneGameInfo::readSpellsInfo(const std::filesystem::path& globalsFolderPath)
+void StandaloneGameInfo::clearSpells()
 {
     spellsInfo.clear();
     allSpells.clear();
     spellsByType.clear();
+}
+
+void StandaloneGameInfo::addSpell(SpellInfoPtr&& info)
+{
+    allSpells.push_back(info.get());
+    spellsByType[info->getSpellType()].push_back(info.get());
+    spellsInfo[info->getSpellId()] = std::move(info);
+}
+
+bool StandaloneGameInfo::readSpellsInfo(const std::filesystem::path& globalsFolderPath)
+{
+    clearSpells();
 
-    Dbf spellsDb{globalsFolderPath / "GSpells.dbf"};
+    Dbf spellsDb{globalsFolderPath / "GSpells.dbf", Dbf::Mode::Mapped};
     if (!spellsDb) {
         std::cerr << "Could not open GSpells.dbf\n";
         return false;
     }
 
+    const Dbf::Column* idColumn{};
+    const Dbf::Column* typeColumn{};
+    const Dbf::Column* levelColumn{};
+    const Dbf::Column* costColumn{};
+    if (!spellsDb.bindColumns({{"SPELL_ID", idColumn},
+                               {"CATEGORY", typeColumn},
+                               {"LEVEL", levelColumn},
+                               {"BUY_C", costColumn}})) {
+        std::cerr << "Missing columns in GSpells.dbf\n";
+        return false;
+    }
+
     for (const auto& record : spellsDb) {
         if (record.deleted()) {
             continue;
         }
 
         CMidgardID spellId;
-        if (!readId(record, "SPELL_ID", spellId)) {
+        if (!readId(record, *idColumn, spellId)) {
             continue;
         }
 
         int type{};
-        if (!record.value(type, "CATEGORY")) {
+        if (!record.value(type, *typeColumn)) {
             continue;
         }
 
         int level{};
-        if (!record.value(level, "LEVEL")) {
+        if (!record.value(level, *levelColumn)) {
             continue;
         }
 
         std::string_view costString{};
-        if (!record.value(costString, "BUY_C")) {
+        if (!record.value(costString, *costColumn)) {
             continue;
         }
 
@@ -701,96 +1101,119 @@ bool StandaloneGameInfo::readSpellsInfo(const std::filesystem::path& globalsFold
 
         auto spellType{static_cast<SpellType>(type)};
 
-        auto info{std::make_unique<StandaloneSpellInfo>(spellId, value, level, spellType)};
-
-        allSpells.push_back(info.get());
-        spellsByType[spellType].push_back(info.get());
-        spellsInfo[spellId] = std::move(info);
+        addSpell(std::make_unique<StandaloneSpellInfo>(spellId, value, level, spellType));
     }
 
     return true;
 }
 
-bool StandaloneGameInfo::readLandmarksInfo(const std::filesystem::path& globalsFolderPath)
+void StandaloneGameInfo::clearLandmarks()
 {
     landmarksInfo.clear();
+    allLandmarks.clear();
     landmarksByType.clear();
     landmarksByRace.clear();
     mountainLandmarks.clear();
+}
 
-    Dbf landmarksDb{globalsFolderPath / "GLmark.dbf"};
+bool StandaloneGameInfo::readLandmarksInfo(const std::filesystem::path& globalsFolderPath)
+{
+    clearLandmarks();
+
+    Dbf landmarksDb{globalsFolderPath / "GLmark.dbf", Dbf::Mode::Mapped};
     if (!landmarksDb) {
         std::cerr << "Could not open GLmark.dbf\n";
         return false;
     }
 
+    const Dbf::Column* idColumn{};
+    const Dbf::Column* xColumn{};
+    const Dbf::Column* yColumn{};
+    const Dbf::Column* mountainColumn{};
+    const Dbf::Column* typeColumn{};
+    if (!landmarksDb.bindColumns({{"LMARK_ID", idColumn},
+                                  {"CX", xColumn},
+                                  {"CY", yColumn},
+                                  {"MOUNTAIN", mountainColumn},
+                                  {"CATEGORY", typeColumn}})) {
+        std::cerr << "Missing columns in GLmark.dbf\n";
+        return false;
+    }
+
     for (const auto& record : landmarksDb) {
         if (record.deleted()) {
             continue;
         }
 
         CMidgardID landmarkId;
-        if (!readId(record, "LMARK_ID", landmarkId)) {
+        if (!readId(record, *idColumn, landmarkId)) {
             continue;
         }
 
         int x{};
-        if (!record.value(x, "CX")) {
+        if (!record.value(x, *xColumn)) {
             continue;
         }
 
         int y{};
-        if (!record.value(y, "CY")) {
+        if (!record.value(y, *yColumn)) {
             continue;
         }
 
         bool mountain{};
-        if (!record.value(mountain, "MOUNTAIN")) {
+        if (!record.value(mountain, *mountainColumn)) {
             continue;
         }
 
         int type{};
-        if (!record.value(type, "CATEGORY")) {
+        if (!record.value(type, *typeColumn)) {
             continue;
         }
 
         auto landmarkType{static_cast<LandmarkType>(type)};
-        auto info{std::make_unique<StandaloneLandmarkInfo>(landmarkId, Position{x, y}, landmarkType,
-                                                           mountain)};
+        addLandmark(std::make_unique<StandaloneLandmarkInfo>(landmarkId, Position{x, y},
+                                                             landmarkType, mountain));
+    }
 
-        if (isEmpireLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Human].push_back(info.get());
-        }
+    return true;
+}
 
-        if (isClansLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Dwarf].push_back(info.get());
-        }
+void StandaloneGameInfo::addLandmark(LandmarkInfoPtr&& info)
+{
+    const auto& landmarkId{info->getLandmarkId()};
 
-        if (isUndeadLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Undead].push_back(info.get());
-        }
+    // Races are assigned by generator settings, they are read before landmarks
+    if (isEmpireLandmark(landmarkId)) {
+        landmarksByRace[RaceType::Human].push_back(info.get());
+    }
 
-        if (isLegionsLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Heretic].push_back(info.get());
-        }
+    if (isClansLandmark(landmarkId)) {
+        landmarksByRace[RaceType::Dwarf].push_back(info.get());
+    }
 
-        if (isElvesLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Elf].push_back(info.get());
-        }
+    if (isUndeadLandmark(landmarkId)) {
+        landmarksByRace[RaceType::Undead].push_back(info.get());
+    }
 
-        if (isNeutralLandmark(landmarkId)) {
-            landmarksByRace[RaceType::Neutral].push_back(info.get());
-        }
+    if (isLegionsLandmark(landmarkId)) {
+        landmarksByRace[RaceType::Heretic].push_back(info.get());
+    }
 
-        if (isMountainLandmark(landmarkId)) {
-            mountainLandmarks.push_back(info.get());
-        }
+    if (isElvesLandmark(landmarkId)) {
+        landmarksByRace[RaceType::Elf].push_back(info.get());
+    }
 
-        landmarksByType[landmarkType].push_back(info.get());
-        landmarksInfo[landmarkId] = std::move(info);
+    if (isNeutralLandmark(landmarkId)) {
+        landmarksByRace[RaceType::Neutral].push_back(info.get());
     }
 
-    return true;
+    if (isMountainLandmark(landmarkId)) {
+        mountainLandmarks.push_back(info.get());
+    }
+
+    landmarksByType[info->getLandmarkType()].push_back(info.get());
+    allLandmarks.push_back(info.get());
+    landmarksInfo[landmarkId] = std::move(info);
 }
 
 bool StandaloneGameInfo::readRacesInfo(const std::filesystem::path& globalsFolderPath)
@@ -799,29 +1222,39 @@ bool StandaloneGameInfo::readRacesInfo(const std::filesystem::path& globalsFolde
 
     std::map<CMidgardID /* race id */, LeaderNames> leaderNames;
 
-    Dbf namesDb{globalsFolderPath / "Tleader.dbf"};
+    Dbf namesDb{globalsFolderPath / "Tleader.dbf", Dbf::Mode::Mapped};
     if (!namesDb) {
         std::cerr << "Could not open Tleader.dbf\n";
         return false;
     }
 
+    const Dbf::Column* raceIdColumn{};
+    const Dbf::Column* maleColumn{};
+    const Dbf::Column* textColumn{};
+    if (!namesDb.bindColumns({{"RACE_ID", raceIdColumn},
+                              {"SEX_M", maleColumn},
+                              {"TEXT", textColumn}})) {
+        std::cerr << "Missing columns in Tleader.dbf\n";
+        return false;
+    }
+
     for (const auto& record : namesDb) {
         if (record.deleted()) {
             continue;
         }
 
         CMidgardID raceId;
-        if (!readId(record, "RACE_ID", raceId)) {
+        if (!readId(record, *raceIdColumn, raceId)) {
             continue;
         }
 
         bool male{};
-        if (!record.value(male, "SEX_M")) {
+        if (!record.value(male, *maleColumn)) {
             continue;
         }
 
         std::string_view nameView{};
-        if (!record.value(nameView, "TEXT")) {
+        if (!record.value(nameView, *textColumn)) {
             continue;
         }
 
@@ -832,13 +1265,28 @@ bool StandaloneGameInfo::readRacesInfo(const std::filesystem::path& globalsFolde
         namesArray.push_back(translate(nameView, maxLeaderNameLength));
     }
 
-    Dbf racesDb{globalsFolderPath / "Grace.dbf"};
+    Dbf racesDb{globalsFolderPath / "Grace.dbf", Dbf::Mode::Mapped};
     if (!racesDb) {
         std::cerr << "Could not open Grace.dbf\n";
         return false;
     }
 
-    char columnName[9] = {'L', 'E', 'A', 'D', 'E', 'R', '_', '1', 0};
+    const Dbf::Column* idColumn{};
+    const Dbf::Column* guardianColumn{};
+    const Dbf::Column* nobleColumn{};
+    const Dbf::Column* typeColumn{};
+    std::array<const Dbf::Column*, 4> leaderColumns{};
+    if (!racesDb.bindColumns({{"RACE_ID", idColumn},
+                              {"GUARDIAN", guardianColumn},
+                              {"NOBLE", nobleColumn},
+                              {"RACE_TYPE", typeColumn},
+                              {"LEADER_1", leaderColumns[0]},
+                              {"LEADER_2", leaderColumns[1]},
+                              {"LEADER_3", leaderColumns[2]},
+                              {"LEADER_4", leaderColumns[3]}})) {
+        std::cerr << "Missing columns in Grace.dbf\n";
+        return false;
+    }
 
     for (const auto& record : racesDb) {
         if (record.deleted()) {
@@ -846,26 +1294,24 @@ bool StandaloneGameInfo::readRacesInfo(const std::filesystem::path& globalsFolde
         }
 
         CMidgardID raceId;
-        if (!readId(record, "RACE_ID", raceId)) {
+        if (!readId(record, *idColumn, raceId)) {
             continue;
         }
 
         CMidgardID guardId;
-        if (!readId(record, "GUARDIAN", guardId)) {
+        if (!readId(record, *guardianColumn, guardId)) {
             continue;
         }
 
         CMidgardID nobleId;
-        if (!readId(record, "NOBLE", nobleId)) {
+        if (!readId(record, *nobleColumn, nobleId)) {
             continue;
         }
 
         bool failed{};
-        std::vector<CMidgardID> leaderIds(4);
+        std::vector<CMidgardID> leaderIds(leaderColumns.size());
         for (std::size_t i = 0; i < std::size(leaderIds); ++i) {
-            columnName[7] = '1' + static_cast<char>(i);
-
-            if (!readId(record, columnName, leaderIds[i])) {
+            if (!readId(record, *leaderColumns[i], leaderIds[i])) {
                 failed = true;
                 break;
             }
@@ -876,7 +1322,7 @@ bool StandaloneGameInfo::readRacesInfo(const std::filesystem::path& globalsFolde
         }
 
         int type;
-        if (!record.value(type, "RACE_TYPE")) {
+        if (!record.value(type, *typeColumn)) {
             continue;
         }
 
@@ -905,13 +1351,19 @@ bool StandaloneGameInfo::readCityNames(const std::filesystem::path& scenDataFold
 {
     cityNames.clear();
 
-    Dbf namesDb{scenDataFolderPath / "Cityname.dbf"};
+    Dbf namesDb{scenDataFolderPath / "Cityname.dbf", Dbf::Mode::Mapped};
     if (!namesDb) {
         std::cerr << "Could not open Cityname.dbf\n";
         return false;
     }
 
-    const auto textLength = namesDb.column("NAME")->length;
+    const Dbf::Column* nameColumn{};
+    if (!namesDb.bindColumns({{"NAME", nameColumn}})) {
+        std::cerr << "Missing columns in Cityname.dbf\n";
+        return false;
+    }
+
+    const auto textLength = nameColumn->length;
 
     for (const auto& record : namesDb) {
         if (record.deleted()) {
@@ -919,7 +1371,7 @@ bool StandaloneGameInfo::readCityNames(const std::filesystem::path& scenDataFold
         }
 
         std::string_view nameView{};
-        if (!record.value(nameView, "NAME")) {
+        if (!record.value(nameView, *nameColumn)) {
             continue;
         }
 
@@ -938,17 +1390,314 @@ bool StandaloneGameInfo::readSiteTexts(const std::filesystem::path& scenDataFold
            && readSiteText(trainerTexts, scenDataFolderPath / "Trainame.dbf");
 }
 
-bool StandaloneGameInfo::readGameInfo(const std::filesystem::path& gameFolderPath)
+bool StandaloneGameInfo::readSnapshot(const std::filesystem::path& snapshotPath,
+                                      const std::vector<char>& snapshotKey)
+{
+    std::error_code error;
+    const auto fileSize{std::filesystem::file_size(snapshotPath, error)};
+    if (error) {
+        return false;
+    }
+
+    // Read the whole file at once, records are decoded from memory
+    std::vector<char> data(static_cast<std::size_t>(fileSize));
+
+    std::ifstream stream(snapshotPath, std::ios_base::binary);
+    if (!stream || !stream.read(data.data(), data.size())) {
+        return false;
+    }
+
+    SnapshotReader reader{data};
+
+    char magic[sizeof(snapshotMagic)];
+    std::uint32_t version{};
+    std::uint32_t byteOrder{};
+    std::vector<char> key;
+    if (!reader.read(magic) || std::memcmp(magic, snapshotMagic, sizeof(magic))
+        || !reader.read(version) || version != snapshotVersion || !reader.read(byteOrder)
+        || byteOrder != snapshotByteOrder || !reader.read(key) || key != snapshotKey) {
+        return false;
+    }
+
+    clearUnits();
+    std::uint32_t count{};
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        CMidgardID unitId, raceId, nameId;
+        int level{}, value{}, hp{}, move{}, leadership{};
+        UnitType unitType{};
+        SubRaceType subrace{};
+        ReachType reach{};
+        AttackType attackType{};
+        bool big{}, male{};
+
+        if (!reader.read(unitId) || !reader.read(raceId) || !reader.read(nameId)
+            || !reader.read(level) || !reader.read(value) || !reader.readEnum(unitType)
+            || !reader.readEnum(subrace) || !reader.readEnum(reach)
+            || !reader.readEnum(attackType) || !reader.read(hp) || !reader.read(move)
+            || !reader.read(leadership) || !reader.read(big) || !reader.read(male)) {
+            return false;
+        }
+
+        addUnit(std::make_unique<StandaloneUnitInfo>(unitId, raceId, nameId, level, value,
+                                                     unitType, subrace, reach, attackType, hp,
+                                                     move, leadership, big, male));
+    }
+
+    clearItems();
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        CMidgardID itemId;
+        int value{};
+        ItemType itemType{};
+        if (!reader.read(itemId) || !reader.read(value) || !reader.readEnum(itemType)) {
+            return false;
+        }
+
+        addItem(std::make_unique<StandaloneItemInfo>(itemId, value, itemType));
+    }
+
+    clearSpells();
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        CMidgardID spellId;
+        int value{}, level{};
+        SpellType spellType{};
+        if (!reader.read(spellId) || !reader.read(value) || !reader.read(level)
+            || !reader.readEnum(spellType)) {
+            return false;
+        }
+
+        addSpell(std::make_unique<StandaloneSpellInfo>(spellId, value, level, spellType));
+    }
+
+    // Landmarks are grouped by races using current generator settings
+    clearLandmarks();
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        CMidgardID landmarkId;
+        int x{}, y{};
+        LandmarkType landmarkType{};
+        bool mountain{};
+        if (!reader.read(landmarkId) || !reader.read(x) || !reader.read(y)
+            || !reader.readEnum(landmarkType) || !reader.read(mountain)) {
+            return false;
+        }
+
+        addLandmark(std::make_unique<StandaloneLandmarkInfo>(landmarkId, Position{x, y},
+                                                             landmarkType, mountain));
+    }
+
+    racesInfo.clear();
+    if (!reader.read(count)) {
+        return false;
+    }
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        CMidgardID raceId, guardId, nobleId;
+        RaceType raceType{};
+        if (!reader.read(raceId) || !reader.read(guardId) || !reader.read(nobleId)
+            || !reader.readEnum(raceType)) {
+            return false;
+        }
+
+        std::uint32_t leadersTotal{};
+        if (!reader.read(leadersTotal)) {
+            return false;
+        }
+
+        std::vector<CMidgardID> leaderIds;
+        for (std::uint32_t j = 0; j < leadersTotal; ++j) {
+            CMidgardID leaderId;
+            if (!reader.read(leaderId)) {
+                return false;
+            }
+
+            leaderIds.push_back(leaderId);
+        }
+
+        LeaderNames names;
+        if (!readSnapshotStrings(names.maleNames, reader)
+            || !readSnapshotStrings(names.femaleNames, reader)) {
+            return false;
+        }
+
+        racesInfo[raceId] = std::make_unique<StandaloneRaceInfo>(raceId, guardId, nobleId,
+                                                                 raceType, std::move(names),
+                                                                 std::move(leaderIds));
+    }
+
+    std::uint32_t end{};
+    return readSnapshotTexts(globalTexts, reader)
+           && readSnapshotTexts(editorInterfaceTexts, reader)
+           && readSnapshotStrings(cityNames, reader)
+           && readSnapshotSiteTexts(mercenaryTexts, reader)
+           && readSnapshotSiteTexts(mageTexts, reader)
+           && readSnapshotSiteTexts(merchantTexts, reader)
+           && readSnapshotSiteTexts(ruinTexts, reader)
+           && readSnapshotSiteTexts(trainerTexts, reader) && reader.read(end)
+           && end == snapshotEnd;
+}
+
+void StandaloneGameInfo::writeSnapshot(const std::filesystem::path& snapshotPath,
+                                       const std::vector<char>& snapshotKey) const
+{
+    SnapshotWriter writer;
+    writer.write(snapshotMagic);
+    writer.write(snapshotVersion);
+    writer.write(snapshotByteOrder);
+    writer.write(snapshotKey);
+
+    // Units are stored in .dbf order, so leaders and soldiers arrays keep it after loading
+    writer.writeSize(units.size());
+    for (const UnitInfo* unit : units) {
+        writer.write(unit->getUnitId());
+        writer.write(unit->getRaceId());
+        writer.write(unit->getNameId());
+        writer.write(unit->getLevel());
+        writer.write(unit->getValue());
+        writer.writeEnum(unit->getUnitType());
+        writer.writeEnum(unit->getSubrace());
+        writer.writeEnum(unit->getAttackReach());
+        writer.writeEnum(unit->getAttackType());
+        writer.write(unit->getHp());
+        writer.write(unit->getMove());
+        writer.write(unit->getLeadership());
+        writer.write(unit->isBig());
+        writer.write(unit->isMale());
+    }
+
+    writer.writeSize(allItems.size());
+    for (const ItemInfo* item : allItems) {
+        writer.write(item->getItemId());
+        writer.write(item->getValue());
+        writer.writeEnum(item->getItemType());
+    }
+
+    writer.writeSize(allSpells.size());
+    for (const SpellInfo* spell : allSpells) {
+        writer.write(spell->getSpellId());
+        writer.write(spell->getValue());
+        writer.write(spell->getLevel());
+        writer.writeEnum(spell->getSpellType());
+    }
+
+    writer.writeSize(allLandmarks.size());
+    for (const LandmarkInfo* landmark : allLandmarks) {
+        const Position& size{landmark->getSize()};
+
+        writer.write(landmark->getLandmarkId());
+        writer.write(size.x);
+        writer.write(size.y);
+        writer.writeEnum(landmark->getLandmarkType());
+        writer.write(landmark->isMountain());
+    }
+
+    writer.writeSize(racesInfo.size());
+    for (const auto& [raceId, race] : racesInfo) {
+        writer.write(raceId);
+        writer.write(race->getGuardianUnitId());
+        writer.write(race->getNobleLeaderId());
+        writer.writeEnum(race->getRaceType());
+
+        const auto& leaderIds{race->getLeaderIds()};
+        writer.writeSize(leaderIds.size());
+        for (const auto& leaderId : leaderIds) {
+            writer.write(leaderId);
+        }
+
+        const LeaderNames& names{race->getLeaderNames()};
+        writeSnapshotStrings(writer, names.maleNames);
+        writeSnapshotStrings(writer, names.femaleNames);
+    }
+
+    writeSnapshotTexts(writer, globalTexts);
+    writeSnapshotTexts(writer, editorInterfaceTexts);
+    writeSnapshotStrings(writer, cityNames);
+    writeSnapshotSiteTexts(writer, mercenaryTexts);
+    writeSnapshotSiteTexts(writer, mageTexts);
+    writeSnapshotSiteTexts(writer, merchantTexts);
+    writeSnapshotSiteTexts(writer, ruinTexts);
+    writeSnapshotSiteTexts(writer, trainerTexts);
+    writer.write(snapshotEnd);
+
+    // Each instance writes its own temporary file next to the snapshot and renames it,
+    // so other generator instances never see partially written snapshot
+    std::random_device device;
+    char suffix[32];
+    std::snprintf(suffix, sizeof(suffix), ".%08x%08x.tmp", device(), device());
+
+    std::filesystem::path tmpPath{snapshotPath};
+    tmpPath += suffix;
+
+    std::error_code error;
+
+    {
+        std::ofstream stream(tmpPath, std::ios_base::binary | std::ios_base::trunc);
+        if (stream) {
+            stream.write(writer.data.data(), writer.data.size());
+            stream.close();
+        }
+
+        if (!stream) {
+            std::cerr << "Could not write game data snapshot\n";
+            std::filesystem::remove(tmpPath, error);
+            return;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, snapshotPath, error);
+    if (error) {
+        std::cerr << "Could not write game data snapshot\n";
+        std::filesystem::remove(tmpPath, error);
+    }
+}
+
+bool StandaloneGameInfo::readGameInfo(const std::filesystem::path& gameFolderPath,
+                                      const std::filesystem::path& snapshotPath)
 {
     const std::filesystem::path globalsFolder{gameFolderPath / "Globals"};
     const std::filesystem::path scenDataFolder{gameFolderPath / "ScenData"};
     const std::filesystem::path interfDataFolder{gameFolderPath / "Interf"};
 
-    return readGeneratorSettings(gameFolderPath) && readRacesInfo(globalsFolder)
-           && readUnitsInfo(globalsFolder) && readItemsInfo(globalsFolder)
-           && readSpellsInfo(globalsFolder) && readLandmarksInfo(globalsFolder)
-           && readGlobalTexts(globalsFolder) && readEditorInterfaceTexts(interfDataFolder)
-           && readCityNames(scenDataFolder) && readSiteTexts(scenDataFolder);
+    // Settings are never cached, they are needed to group landmarks by races
+    if (!readGeneratorSettings(gameFolderPath)) {
+        return false;
+    }
+
+    std::vector<char> snapshotKey;
+    const bool useSnapshot{!snapshotPath.empty()
+                           && createSnapshotKey(snapshotKey, gameFolderPath)};
+
+    if (useSnapshot && readSnapshot(snapshotPath, snapshotKey)) {
+        return true;
+    }
+
+    if (!readRacesInfo(globalsFolder) || !readUnitsInfo(globalsFolder)
+        || !readItemsInfo(globalsFolder) || !readSpellsInfo(globalsFolder)
+        || !readLandmarksInfo(globalsFolder) || !readGlobalTexts(globalsFolder)
+        || !readEditorInterfaceTexts(interfDataFolder) || !readCityNames(scenDataFolder)
+        || !readSiteTexts(scenDataFolder)) {
+        return false;
+    }
+
+    if (useSnapshot) {
+        writeSnapshot(snapshotPath, snapshotKey);
+    }
+
+    return true;
 }
 
 } // namespace rsg
@@ -21,6 +21,7 @@
 
 #include "gameinfo.h"
 #include <filesystem>
+#include <vector>
 
 namespace rsg {
 
@@ -28,7 +29,10 @@ namespace rsg {
 class StandaloneGameInfo final : public GameInfo
 {
 public:
-    StandaloneGameInfo(const std::filesystem::path& gameFolderPath);
+    // Parsed game data is cached in snapshot file, if its path is specified.
+    // Snapshot is rebuilt when any of the source .dbf files changes
+    StandaloneGameInfo(const std::filesystem::path& gameFolderPath,
+                       const std::filesystem::path& snapshotPath = {});
 
     ~StandaloneGameInfo() override = default;
 
@@ -87,7 +91,23 @@ public:
     const SiteTexts& getTrainerTexts() const override;
 
 private:
-    bool readGameInfo(const std::filesystem::path& gameFolderPath);
+    bool readGameInfo(const std::filesystem::path& gameFolderPath,
+                      const std::filesystem::path& snapshotPath);
+
+    bool readSnapshot(const std::filesystem::path& snapshotPath,
+                      const std::vector<char>& snapshotKey);
+    void writeSnapshot(const std::filesystem::path& snapshotPath,
+                       const std::vector<char>& snapshotKey) const;
+
+    void clearUnits();
+    void clearItems();
+    void clearSpells();
+    void clearLandmarks();
+
+    void addUnit(UnitInfoPtr&& info);
+    void addItem(ItemInfoPtr&& info);
+    void addSpell(SpellInfoPtr&& info);
+    void addLandmark(LandmarkInfoPtr&& info);
 
     bool readUnitsInfo(const std::filesystem::path& globalsFolderPath);
     bool readItemsInfo(const std::filesystem::path& globalsFolderPath);
@@ -104,6 +124,7 @@ private:
     const char* getText(const TextsInfo& texts, const CMidgardID& textId) const;
 
     UnitsInfo unitsInfo{};
+    UnitInfoArray units{};
     UnitInfoArray leaders{};
     UnitInfoArray soldiers{};
 
@@ -122,6 +143,7 @@ private:
     std::map<SpellType, SpellInfoArray> spellsByType;
 
     LandmarksInfo landmarksInfo;
+    LandmarkInfoArray allLandmarks;
     std::map<LandmarkType, LandmarkInfoArray> landmarksByType;
     std::map<RaceType, LandmarkInfoArray> landmarksByRace;
     LandmarkInfoArray mountainLandmarks;